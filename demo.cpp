@@ -1,12 +1,18 @@
 #include <array>
 #include <stdint.h>
 
+#include "json-base64.h"
+#include "json-interning.h"
 #include "json-parsing.h"
 #include <iostream>
 #include <vector>
 
+enum ColourFormat : uint8_t { Greyscale, RGB, RGBA };
+
+JSON_ENUM(ColourFormat, Greyscale, RGB, RGBA)
+
 struct Image {
-  uint8_t colourFormat;
+  ColourFormat colourFormat;
   virtual uint32_t getAveragePixelValue() = 0;
 };
 
@@ -22,7 +28,7 @@ struct StoredImage : public Image {
     return sum / data.size();
   }
 };
-JSON(StoredImage, FIELDS(data, x, y));
+JSON(StoredImage, FIELDS(BASE64(data), x, y));
 
 template <typename Dimension_T> struct RemoteImage : public Image {
   std::string url;
@@ -55,7 +61,7 @@ JSON(Image *, SUBTYPES(RemoteImage<uint16_t>, StoredImage, BinaryTable),
                                     // declared after the pointers to allow reparsing of serialized objects.
 
 struct Comment {
-  std::string author;
+  InternedString author;
   std::string content;
   uint64_t timestamp;
 };
@@ -210,5 +216,14 @@ int main() {
   out_json = prettify_json(out_json);
   std::cout << std::string(out_json.begin(), out_json.end()) << std::endl;
 
+  std::string broken_json = R"({"title": "Broken post", "timestamp": "yesterday"})";
+  std::cout << "Post is " << (json<BlogPost>::validate(json_string) ? "valid" : "invalid") << ", broken post is "
+            << (json<BlogPost>::validate(broken_json) ? "valid" : "invalid") << std::endl;
+  auto broken_post = json<BlogPost>::try_deserialize(broken_json);
+  if (!broken_post) {
+    std::cout << parse_error_code_to_string(broken_post.error().code) << " at offset " << broken_post.error().offset
+              << std::endl;
+  }
+
   return 0;
 }
\ No newline at end of file
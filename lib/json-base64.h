@@ -0,0 +1,230 @@
+#pragma once
+
+#include "json-parsing.h"
+
+#include <array>
+#include <cstdint>
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define __JSON_BASE64_SSSE3
+#endif
+
+// Field annotation for byte containers (e.g. std::vector<uint8_t>) that should be stored as a base64 string instead
+// of an array of numbers: JSON(T, FIELDS(BASE64(data), ...))
+#define BASE64(Name) ENCODED(Base64Encoding, Name)
+
+template <class T_Container>
+concept is_byte_container = is_container<T_Container> && sizeof(typename T_Container::value_type) == 1 &&
+                            requires(T_Container &c, size_t n) {
+                              c.resize(n);
+                              c.data();
+                              c.size();
+                            };
+
+inline constexpr char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#define BASE64_INVALID 0xFF
+
+inline constexpr std::array<uint8_t, 256> BASE64_DECODING_TABLE = []() {
+  std::array<uint8_t, 256> table{};
+  table.fill(BASE64_INVALID);
+  for (uint8_t i = 0; i < 64; i++) {
+    table[static_cast<uint8_t>(BASE64_ALPHABET[i])] = i;
+  }
+  return table;
+}();
+
+#ifdef __JSON_BASE64_SSSE3
+
+// Encodes the first 12 bytes of the input to 16 characters (W. Muła, "Base64 encoding with SIMD instructions")
+inline __m128i base64_encode_block(__m128i input) {
+  input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+  const __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  const __m128i indices = _mm_or_si128(t1, t3);
+
+  // Map the 6-bit indices to a small number identifying their alphabet range, then add that range's offset
+  __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  range = _mm_or_si128(range, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+  const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+inline __m128i in_range(__m128i input, char low, char high) {
+  return _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8(low - 1)), _mm_cmplt_epi8(input, _mm_set1_epi8(high + 1)));
+}
+
+// Decodes 16 characters to 12 bytes, stored in the lower 12 bytes of the result. Returns false if any of the
+// characters is not part of the alphabet.
+inline bool base64_decode_block(__m128i input, __m128i &output) {
+  const __m128i upper = in_range(input, 'A', 'Z');
+  const __m128i lower = in_range(input, 'a', 'z');
+  const __m128i digit = in_range(input, '0', '9');
+  const __m128i plus = _mm_cmpeq_epi8(input, _mm_set1_epi8('+'));
+  const __m128i slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+  const __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+  if (_mm_movemask_epi8(valid) != 0xFFFF) {
+    return false;
+  }
+
+  __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+  shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+  shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+  shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+  shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+  const __m128i values = _mm_add_epi8(input, shift);
+
+  // Merge pairs of 6-bit values into 12 bits, then pairs of those into 24 bits and bring the bytes into order
+  const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)),
+                                        _mm_set1_epi32(0x00011000));
+  output = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+  return true;
+}
+
+#endif
+
+inline constexpr size_t base64_decoded_capacity(size_t length) { return length / 4 * 3 + 3; }
+
+template <std::output_iterator<char> OutputIterator>
+inline void base64_encode(const uint8_t *data, size_t length, OutputIterator &output) {
+  size_t i = 0;
+#ifdef __JSON_BASE64_SSSE3
+  // Blocks consume 12 bytes but load 16, so stop while a full load is still in bounds
+  char block[16];
+  for (; i + 16 <= length; i += 12) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(block),
+                     base64_encode_block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i))));
+    output = std::copy(block, block + 16, output);
+  }
+#endif
+  for (; i + 3 <= length; i += 3) {
+    uint32_t triple = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    *output++ = BASE64_ALPHABET[(triple >> 18) & 0x3F];
+    *output++ = BASE64_ALPHABET[(triple >> 12) & 0x3F];
+    *output++ = BASE64_ALPHABET[(triple >> 6) & 0x3F];
+    *output++ = BASE64_ALPHABET[triple & 0x3F];
+  }
+  if (i + 1 == length) {
+    *output++ = BASE64_ALPHABET[data[i] >> 2];
+    *output++ = BASE64_ALPHABET[(data[i] & 0x03) << 4];
+    *output++ = '=';
+    *output++ = '=';
+  } else if (i + 2 == length) {
+    *output++ = BASE64_ALPHABET[data[i] >> 2];
+    *output++ = BASE64_ALPHABET[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)];
+    *output++ = BASE64_ALPHABET[(data[i + 1] & 0x0F) << 2];
+    *output++ = '=';
+  }
+}
+
+// Decodes padded or unpadded base64 into output, which must have room for base64_decoded_capacity(length) bytes.
+// Returns false if the input is not valid base64.
+inline bool base64_decode(const char *input, size_t length, uint8_t *output, size_t &written) {
+  if (length % 4 == 0 && length > 0 && input[length - 1] == '=') {
+    length -= input[length - 2] == '=' ? 2 : 1;
+  }
+  if (length % 4 == 1) {
+    return false;
+  }
+
+  uint8_t *cursor = output;
+  size_t i = 0;
+#ifdef __JSON_BASE64_SSSE3
+  for (; i + 16 <= length; i += 16) {
+    __m128i block;
+    if (!base64_decode_block(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i)), block)) {
+      return false;
+    }
+    char bytes[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes), block);
+    std::memcpy(cursor, bytes, 12);
+    cursor += 12;
+  }
+#endif
+  uint32_t quad = 0;
+  size_t pending = 0;
+  for (; i < length; i++) {
+    uint8_t value = BASE64_DECODING_TABLE[static_cast<uint8_t>(input[i])];
+    if (value == BASE64_INVALID) {
+      return false;
+    }
+    quad = (quad << 6) | value;
+    if (++pending == 4) {
+      *cursor++ = quad >> 16;
+      *cursor++ = quad >> 8;
+      *cursor++ = quad;
+      quad = 0;
+      pending = 0;
+    }
+  }
+  if (pending == 2) {
+    *cursor++ = quad >> 4;
+  } else if (pending == 3) {
+    *cursor++ = quad >> 10;
+    *cursor++ = quad >> 2;
+  }
+  written = cursor - output;
+  return true;
+}
+
+inline bool base64_valid(const char *input, size_t length) {
+  if (length % 4 == 0 && length > 0 && input[length - 1] == '=') {
+    length -= input[length - 2] == '=' ? 2 : 1;
+  }
+  if (length % 4 == 1) {
+    return false;
+  }
+  return std::all_of(input, input + length, [](char c) {
+    return BASE64_DECODING_TABLE[static_cast<uint8_t>(c)] != BASE64_INVALID;
+  });
+}
+
+// Encodes byte containers as base64 strings. The string is decoded directly into the container's storage.
+struct Base64Encoding {
+  template <ParseMode Mode, TokenStream StreamType, is_byte_container T_Container>
+  static ParseResult parse_tokenstream(StreamType &stream, T_Container &field) {
+    if (stream->type != Token::Type::String) {
+      return parse_error(stream, ParseErrorCode::ExpectedString);
+    }
+    // Like arrays, base64 strings are appended to the container unless it is being reused
+    size_t offset = Mode == ParseMode::Reuse ? 0 : field.size();
+    size_t written = 0;
+    field.resize(offset + base64_decoded_capacity(stream->length));
+    if (!base64_decode(stream->value, stream->length, reinterpret_cast<uint8_t *>(field.data()) + offset, written)) {
+      field.resize(offset);
+      return parse_error(stream, ParseErrorCode::InvalidBase64);
+    }
+    field.resize(offset + written);
+    ++stream;
+    return {};
+  }
+
+  template <is_byte_container T_Container, TokenStream StreamType>
+  static ParseResult validate_tokenstream(StreamType &stream) {
+    if (stream->type != Token::Type::String) {
+      return parse_error(stream, ParseErrorCode::ExpectedString);
+    }
+    if (!base64_valid(stream->value, stream->length)) {
+      return parse_error(stream, ParseErrorCode::InvalidBase64);
+    }
+    ++stream;
+    return {};
+  }
+
+  template <is_byte_container T_Container, std::output_iterator<char> OutputIterator>
+  static void serialize(T_Container const &field, OutputIterator &output) {
+    *output++ = '"';
+    base64_encode(reinterpret_cast<const uint8_t *>(field.data()), field.size(), output);
+    *output++ = '"';
+  }
+
+  template <is_byte_container T_Container, std::output_iterator<char> OutputIterator>
+  static void serialize_diff(T_Container const &old_field, T_Container const &field, OutputIterator &output) {
+    serialize(field, output);
+  }
+};
@@ -0,0 +1,377 @@
+#pragma once
+
+#include "json-parsing.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+// zstd support is enabled if <zstd.h> was included before this header (the program then has to link libzstd)
+#ifdef ZSTD_VERSION_MAJOR
+#define __JSON_ZSTD
+#endif
+
+// Size of the buffers the input is decompressed into
+#ifndef COMPRESSED_INPUT_BUFFER_SIZE
+#define COMPRESSED_INPUT_BUFFER_SIZE (1 << 16)
+#endif
+
+// Number of buffers in the ring. While waiting for the next buffer, the parser holds on to at most four of them (those
+// of the last three tokens and the one being tokenized), so the decompressor can always work ahead into at least one.
+#define COMPRESSED_INPUT_BUFFERS 5
+
+// Space in front of each buffer into which a token cut off at the end of the previous buffer is moved, so that every
+// token is contiguous. Longer tokens are stitched together in a separate allocation.
+#define COMPRESSED_INPUT_CARRY_SIZE 4096
+
+// Reads gzip files. zlib passes files that are not compressed through unchanged.
+class GzipSource {
+  gzFile file;
+
+public:
+  explicit GzipSource(std::string const &path) : file(gzopen(path.c_str(), "rb")) {
+    if (file) {
+      gzbuffer(file, COMPRESSED_INPUT_BUFFER_SIZE);
+    }
+  }
+  GzipSource(GzipSource const &) = delete;
+  ~GzipSource() {
+    if (file) {
+      gzclose(file);
+    }
+  }
+
+  bool is_open() const { return file != nullptr; }
+
+  // Returns the number of bytes written to output, 0 at the end of the input or -1 if the input is corrupt
+  long read(char *output, size_t capacity) {
+    int length = gzread(file, output, static_cast<unsigned>(capacity));
+    if (length == 0) {
+      int error;
+      gzerror(file, &error);
+      return error == Z_OK ? 0 : -1;
+    }
+    return length;
+  }
+};
+
+#ifdef __JSON_ZSTD
+class ZstdSource {
+  FILE *file;
+  ZSTD_DStream *stream;
+  std::unique_ptr<char[]> input;
+  ZSTD_inBuffer inputBuffer;
+  size_t pending = 0;
+
+public:
+  explicit ZstdSource(std::string const &path)
+      : file(std::fopen(path.c_str(), "rb")), stream(ZSTD_createDStream()),
+        input(std::make_unique<char[]>(ZSTD_DStreamInSize())), inputBuffer{input.get(), 0, 0} {}
+  ZstdSource(ZstdSource const &) = delete;
+  ~ZstdSource() {
+    ZSTD_freeDStream(stream);
+    if (file) {
+      std::fclose(file);
+    }
+  }
+
+  bool is_open() const { return file != nullptr; }
+
+  // Returns the number of bytes written to output, 0 at the end of the input or -1 if the input is corrupt
+  long read(char *output, size_t capacity) {
+    ZSTD_outBuffer outputBuffer{output, capacity, 0};
+    while (outputBuffer.pos < outputBuffer.size) {
+      if (inputBuffer.pos == inputBuffer.size) {
+        inputBuffer.size = std::fread(input.get(), 1, ZSTD_DStreamInSize(), file);
+        inputBuffer.pos = 0;
+        if (inputBuffer.size == 0) {
+          break;
+        }
+      }
+      pending = ZSTD_decompressStream(stream, &outputBuffer, &inputBuffer);
+      if (ZSTD_isError(pending)) {
+        return -1;
+      }
+    }
+    // A frame that is still pending at the end of the file has been cut off
+    if (outputBuffer.pos == 0 && (pending != 0 || std::ferror(file))) {
+      return -1;
+    }
+    return static_cast<long>(outputBuffer.pos);
+  }
+};
+#endif
+
+// Decompresses a source on a background thread into a fixed ring of buffers, so that decompression overlaps with
+// parsing and memory use stays bounded. Filled buffers are handed out in input order and can be released in any order.
+template <class Source> class DecompressionPipeline {
+public:
+  struct Buffer {
+    std::unique_ptr<char[]> storage =
+        std::make_unique<char[]>(COMPRESSED_INPUT_CARRY_SIZE + COMPRESSED_INPUT_BUFFER_SIZE);
+    size_t length = 0;
+
+    char *data() { return storage.get() + COMPRESSED_INPUT_CARRY_SIZE; }
+  };
+
+  explicit DecompressionPipeline(Source &source) : source(source) {
+    for (auto &buffer : buffers) {
+      free.push_back(&buffer);
+    }
+    worker = std::thread(&DecompressionPipeline::decompress, this);
+  }
+  DecompressionPipeline(DecompressionPipeline const &) = delete;
+  ~DecompressionPipeline() {
+    {
+      std::lock_guard lock(mutex);
+      stopped = true;
+    }
+    changed.notify_all();
+    worker.join();
+  }
+
+  // Waits for the next part of the input. Returns nullptr at the end of the input or if decompression failed.
+  Buffer *acquire() {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [&]() { return !filled.empty() || finished; });
+    if (filled.empty()) {
+      return nullptr;
+    }
+    Buffer *buffer = filled.front();
+    filled.pop_front();
+    return buffer;
+  }
+
+  void release(Buffer *buffer) {
+    {
+      std::lock_guard lock(mutex);
+      free.push_back(buffer);
+    }
+    changed.notify_all();
+  }
+
+  bool failed() const {
+    std::lock_guard lock(mutex);
+    return failure;
+  }
+
+private:
+  void decompress() {
+    while (true) {
+      Buffer *buffer;
+      {
+        std::unique_lock lock(mutex);
+        changed.wait(lock, [&]() { return !free.empty() || stopped; });
+        if (stopped) {
+          return;
+        }
+        buffer = free.back();
+        free.pop_back();
+      }
+
+      size_t length = 0;
+      long read = 0;
+      while (length < COMPRESSED_INPUT_BUFFER_SIZE &&
+             (read = source.read(buffer->data() + length, COMPRESSED_INPUT_BUFFER_SIZE - length)) > 0) {
+        length += read;
+      }
+
+      {
+        std::lock_guard lock(mutex);
+        buffer->length = length;
+        if (length > 0) {
+          filled.push_back(buffer);
+        } else {
+          free.push_back(buffer);
+        }
+        failure = read < 0;
+        finished = read <= 0;
+      }
+      changed.notify_all();
+      if (read <= 0) {
+        return;
+      }
+    }
+  }
+
+  Source &source;
+  std::array<Buffer, COMPRESSED_INPUT_BUFFERS> buffers;
+  std::vector<Buffer *> free;
+  std::deque<Buffer *> filled;
+  mutable std::mutex mutex;
+  std::condition_variable changed;
+  bool stopped = false;
+  bool finished = false;
+  bool failure = false;
+  std::thread worker;
+};
+
+// Single-pass token stream over a DecompressionPipeline. Each buffer is tokenized in place. A token cut off at the
+// end of a buffer is moved in front of the next buffer and tokenized again from there. A buffer is kept until none of
+// the last three tokens points into it, since parsers hold on to an object key while reading the colon and the value.
+template <class Source> class DecompressingTokenStream {
+  using Buffer = typename DecompressionPipeline<Source>::Buffer;
+
+  // A contiguous part of the input, stored in a buffer of the ring or, for long tokens, in its own allocation
+  struct Window {
+    Buffer *buffer;
+    std::unique_ptr<char[]> stitched;
+    size_t lastToken;
+  };
+
+  DecompressionPipeline<Source> &pipeline;
+  std::deque<Window> windows;
+  std::optional<Tokenizer<const char *>> tokenizer;
+  const char *windowBegin = nullptr;
+  const char *windowEnd = nullptr;
+  size_t windowOffset = 0;
+  size_t tokenCount = 0;
+
+  // Continues tokenizing in the next buffer, starting with the unread rest of the current window. Returns false at the
+  // end of the input.
+  bool next_window(const char *rest) {
+    Buffer *buffer = pipeline.acquire();
+    if (!buffer) {
+      return false;
+    }
+
+    size_t carry = windowEnd - rest;
+    size_t length = carry + buffer->length;
+    Window window{buffer, nullptr, 0};
+    char *begin;
+    if (carry <= COMPRESSED_INPUT_CARRY_SIZE) {
+      begin = buffer->data() - carry;
+    } else {
+      window.stitched = std::make_unique<char[]>(length);
+      begin = window.stitched.get();
+      std::memcpy(begin + carry, buffer->data(), buffer->length);
+      pipeline.release(buffer);
+      window.buffer = nullptr;
+    }
+    if (carry > 0) {
+      std::memcpy(begin, rest, carry);
+    }
+
+    windowOffset += rest - windowBegin;
+    windowBegin = begin;
+    windowEnd = begin + length;
+    windows.push_back(std::move(window));
+    tokenizer.emplace(windowBegin, windowEnd);
+    release_windows();
+    return true;
+  }
+
+  void release_windows() {
+    for (auto it = windows.begin(); it != windows.end() && it + 1 != windows.end();) {
+      if (it->lastToken == 0 || it->lastToken + 2 < tokenCount) {
+        if (it->buffer) {
+          pipeline.release(it->buffer);
+        }
+        it = windows.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+public:
+  explicit DecompressingTokenStream(DecompressionPipeline<Source> &pipeline) : pipeline(pipeline) {
+    tokenizer.emplace(windowBegin, windowEnd);
+  }
+  DecompressingTokenStream(DecompressingTokenStream const &) = delete;
+  ~DecompressingTokenStream() {
+    for (auto &window : windows) {
+      if (window.buffer) {
+        pipeline.release(window.buffer);
+      }
+    }
+  }
+
+  inline bool operator==(DecompressingTokenStream const &other) const { return this == &other; }
+  inline Token &operator*() { return **tokenizer; }
+  inline Token *operator->() { return &**tokenizer; }
+
+  // Byte offset of the current token from the start of the decompressed input
+  inline size_t offset() const { return windowOffset + tokenizer->offset(); }
+
+  inline void operator++(int) { ++*this; }
+  inline DecompressingTokenStream &operator++() {
+    const char *rest = tokenizer->raw_cursor();
+    ++*tokenizer;
+    while ((*tokenizer)->type == Token::Type::End && next_window(rest)) {
+      rest = tokenizer->raw_cursor();
+      ++*tokenizer;
+    }
+    if (!windows.empty()) {
+      windows.back().lastToken = ++tokenCount;
+    }
+    release_windows();
+    return *this;
+  }
+};
+
+// Deserializes gzip or zstd compressed files (and uncompressed ones) without decompressing them in full first. The
+// file is decompressed on a background thread while the calling thread parses, and memory use for the input is
+// bounded by the ring of COMPRESSED_INPUT_BUFFERS buffers, apart from single tokens longer than a buffer.
+template <typename T> struct compressed_json {
+  static T deserialize(std::string const &path) {
+    T res;
+    deserialize(path, res);
+    return res;
+  }
+
+  static void deserialize(std::string const &path, T &output) {
+    if (auto result = try_deserialize(path, output); !result) {
+      throw ParseException(result.error());
+    }
+  }
+
+  static std::expected<T, ParseError> try_deserialize(std::string const &path) {
+    T res;
+    __JSON_PROPAGATE(try_deserialize(path, res));
+    return res;
+  }
+
+  static ParseResult try_deserialize(std::string const &path, T &output) {
+    if (is_zstd_file(path)) {
+#ifdef __JSON_ZSTD
+      return parse<ZstdSource>(path, output);
+#else
+      return std::unexpected(ParseError{ParseErrorCode::DecompressionFailed, 0});
+#endif
+    }
+    return parse<GzipSource>(path, output);
+  }
+
+private:
+  static bool is_zstd_file(std::string const &path) {
+    unsigned char magic[4] = {};
+    if (FILE *file = std::fopen(path.c_str(), "rb")) {
+      std::fread(magic, 1, sizeof(magic), file);
+      std::fclose(file);
+    }
+    return magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD;
+  }
+
+  template <class Source> static ParseResult parse(std::string const &path, T &output) {
+    Source source(path);
+    if (!source.is_open()) {
+      return std::unexpected(ParseError{ParseErrorCode::InputUnavailable, 0});
+    }
+    DecompressionPipeline<Source> pipeline(source);
+    DecompressingTokenStream<Source> stream(pipeline);
+    auto result = parse_field(++stream, output);
+    if (!result && pipeline.failed()) {
+      return std::unexpected(ParseError{ParseErrorCode::DecompressionFailed, stream.offset()});
+    }
+    return result;
+  }
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "json-parsing.h"
+
+#include <initializer_list>
+
+// Vector with inline storage for up to N elements, for members that must not allocate. All N elements are constructed
+// along with the vector, the ones behind size() are kept for reuse. Input with more than N elements is a parse error
+// (CapacityExceeded) instead of growing the vector.
+template <typename T, size_t N> class FixedVector {
+  static_assert(!std::is_same_v<T, char>, "FixedString should be used for strings!");
+
+  template <is_container T_Container> friend struct container_json;
+
+  T elements[N > 0 ? N : 1] = {};
+  size_t count = 0;
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using iterator = T *;
+  using const_iterator = T const *;
+
+  constexpr FixedVector() = default;
+  constexpr FixedVector(std::initializer_list<T> values) {
+    if (values.size() > N) {
+      throw std::length_error("FixedVector capacity exceeded!");
+    }
+    std::copy(values.begin(), values.end(), elements);
+    count = values.size();
+  }
+
+  constexpr iterator begin() { return elements; }
+  constexpr iterator end() { return elements + count; }
+  constexpr const_iterator begin() const { return elements; }
+  constexpr const_iterator end() const { return elements + count; }
+  constexpr T *data() { return elements; }
+  constexpr T const *data() const { return elements; }
+  constexpr T &operator[](size_t index) { return elements[index]; }
+  constexpr T const &operator[](size_t index) const { return elements[index]; }
+  constexpr T &back() { return elements[count - 1]; }
+  constexpr T const &back() const { return elements[count - 1]; }
+
+  constexpr size_t size() const { return count; }
+  static constexpr size_t capacity() { return N; }
+  constexpr bool empty() const { return count == 0; }
+  constexpr bool full() const { return count == N; }
+
+  // Returns false instead of growing if the vector is full
+  constexpr bool push_back(T const &value) {
+    if (count == N) {
+      return false;
+    }
+    elements[count++] = value;
+    return true;
+  }
+  constexpr bool push_back(T &&value) {
+    if (count == N) {
+      return false;
+    }
+    elements[count++] = std::move(value);
+    return true;
+  }
+  constexpr void pop_back() { count--; }
+  constexpr void clear() { count = 0; }
+
+  friend constexpr bool operator==(FixedVector const &a, FixedVector const &b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+  }
+};
+
+// String with inline storage for up to N characters, kept null-terminated. Longer strings in the input are a parse
+// error (CapacityExceeded) instead of being truncated.
+template <size_t N> class FixedString {
+  char characters[N + 1] = {};
+  size_t length = 0;
+
+public:
+  using value_type = char;
+  using size_type = size_t;
+  using iterator = char *;
+  using const_iterator = const char *;
+
+  constexpr FixedString() = default;
+  constexpr FixedString(std::string_view value) {
+    if (!assign(value)) {
+      throw std::length_error("FixedString capacity exceeded!");
+    }
+  }
+  constexpr FixedString(const char *value) : FixedString(std::string_view(value)) {}
+
+  // Returns false and leaves the string unchanged if the value does not fit
+  constexpr bool assign(std::string_view value) {
+    if (value.size() > N) {
+      return false;
+    }
+    std::copy(value.begin(), value.end(), characters);
+    characters[value.size()] = 0;
+    length = value.size();
+    return true;
+  }
+
+  constexpr iterator begin() { return characters; }
+  constexpr iterator end() { return characters + length; }
+  constexpr const_iterator begin() const { return characters; }
+  constexpr const_iterator end() const { return characters + length; }
+  constexpr const char *data() const { return characters; }
+  constexpr const char *c_str() const { return characters; }
+  constexpr std::string_view view() const { return {characters, length}; }
+  constexpr operator std::string_view() const { return view(); }
+
+  constexpr size_t size() const { return length; }
+  static constexpr size_t capacity() { return N; }
+  constexpr bool empty() const { return length == 0; }
+  constexpr void clear() { assign({}); }
+
+  friend constexpr bool operator==(FixedString const &a, FixedString const &b) { return a.view() == b.view(); }
+  friend constexpr bool operator==(FixedString const &a, std::string_view b) { return a.view() == b; }
+  friend constexpr bool operator==(FixedString const &a, const char *b) { return a.view() == b; }
+};
+
+// Like other containers, vectors are appended to unless they are being reused
+template <typename T, size_t N> struct container_json<FixedVector<T, N>> {
+  template <ParseMode Mode = ParseMode::Construct, TokenStream StreamType>
+  static constexpr ParseResult parse_tokenstream(StreamType &stream, FixedVector<T, N> &output) {
+    return parse_tokenstream_bounded<Mode>(stream, output.elements, N, output.count);
+  }
+
+  template <TokenStream StreamType> static constexpr ParseResult validate_tokenstream(StreamType &stream) {
+    return validate_tokenstream_bounded<StreamType, T>(stream, N);
+  }
+};
+
+template <size_t N> struct container_json<FixedString<N>> {
+  template <ParseMode Mode = ParseMode::Construct, TokenStream StreamType>
+  static constexpr ParseResult parse_tokenstream(StreamType &stream, FixedString<N> &output) {
+    if (stream->type != Token::Type::String) {
+      return parse_error(stream, ParseErrorCode::ExpectedString);
+    }
+    if (!output.assign(std::string_view(stream->value, stream->length))) {
+      return parse_error(stream, ParseErrorCode::CapacityExceeded);
+    }
+    ++stream;
+    return {};
+  }
+
+  template <TokenStream StreamType> static constexpr ParseResult validate_tokenstream(StreamType &stream) {
+    if (stream->type != Token::Type::String) {
+      return parse_error(stream, ParseErrorCode::ExpectedString);
+    }
+    if (stream->length > N) {
+      return parse_error(stream, ParseErrorCode::CapacityExceeded);
+    }
+    ++stream;
+    return {};
+  }
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "json-parsing.h"
+
+#include <array>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+// Number of independently locked parts of the string pool, so that threads parsing in parallel rarely wait on each
+// other
+#define STRING_POOL_SHARDS 16
+
+// Interned strings are copied into blocks of this size. Longer strings get a block of their own.
+#define STRING_POOL_BLOCK_SIZE 4096
+
+// Process-wide set of immutable strings. Interning equal values yields the same storage, which stays valid until the
+// end of the program, so only values from a small set (names, tags, enum-like strings) should be interned.
+class StringPool {
+public:
+  static StringPool &global() {
+    static StringPool pool;
+    return pool;
+  }
+
+  std::string_view intern(std::string_view value) {
+    if (value.empty()) {
+      return {};
+    }
+    size_t hash = std::hash<std::string_view>()(value);
+    return shards[std::rotr(hash, 16) % STRING_POOL_SHARDS].intern(value);
+  }
+
+  // Number of distinct strings in the pool
+  size_t size() const {
+    size_t count = 0;
+    for (auto const &shard : shards) {
+      std::lock_guard lock(shard.mutex);
+      count += shard.strings.size();
+    }
+    return count;
+  }
+
+  // Bytes allocated for the characters of the interned strings
+  size_t memory_usage() const {
+    size_t bytes = 0;
+    for (auto const &shard : shards) {
+      std::lock_guard lock(shard.mutex);
+      bytes += shard.allocated;
+    }
+    return bytes;
+  }
+
+private:
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_set<std::string_view> strings;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *cursor = nullptr;
+    size_t remaining = 0;
+    size_t allocated = 0;
+
+    std::string_view intern(std::string_view value) {
+      std::lock_guard lock(mutex);
+      if (auto it = strings.find(value); it != strings.end()) {
+        return *it;
+      }
+      char *storage = allocate(value.size());
+      std::memcpy(storage, value.data(), value.size());
+      return *strings.emplace(storage, value.size()).first;
+    }
+
+    char *allocate(size_t length) {
+      if (length > STRING_POOL_BLOCK_SIZE / 4) {
+        allocated += length;
+        return blocks.emplace_back(std::make_unique<char[]>(length)).get();
+      }
+      if (length > remaining) {
+        allocated += STRING_POOL_BLOCK_SIZE;
+        cursor = blocks.emplace_back(std::make_unique<char[]>(STRING_POOL_BLOCK_SIZE)).get();
+        remaining = STRING_POOL_BLOCK_SIZE;
+      }
+      char *storage = cursor;
+      cursor += length;
+      remaining -= length;
+      return storage;
+    }
+  };
+
+  std::array<Shard, STRING_POOL_SHARDS> shards;
+};
+
+// Handle to a string in the global StringPool, to be used instead of std::string for members whose values repeat
+// across many objects. Equal values share their storage, so handles are copied and compared as pointers.
+class InternedString {
+public:
+  InternedString() = default;
+  InternedString(std::string_view value) : value(StringPool::global().intern(value)) {}
+  InternedString(std::string const &value) : InternedString(std::string_view(value)) {}
+  InternedString(const char *value) : InternedString(std::string_view(value)) {}
+
+  constexpr std::string_view view() const { return value; }
+  constexpr operator std::string_view() const { return value; }
+  constexpr const char *data() const { return value.data(); }
+  constexpr size_t size() const { return value.size(); }
+  constexpr bool empty() const { return value.empty(); }
+
+  friend constexpr bool operator==(InternedString const &a, InternedString const &b) {
+    return a.value.data() == b.value.data();
+  }
+  friend constexpr bool operator==(InternedString const &a, std::string_view b) { return a.value == b; }
+  friend constexpr bool operator==(InternedString const &a, const char *b) { return a.value == b; }
+
+private:
+  std::string_view value;
+};
+
+template <> struct std::hash<InternedString> {
+  size_t operator()(InternedString const &string) const { return std::hash<const char *>()(string.data()); }
+};
+
+template <>
+template <ParseMode Mode, TokenStream StreamType>
+inline constexpr ParseResult json<InternedString>::parse_tokenstream(StreamType &stream, InternedString &output) {
+  if (stream->type == Token::Type::String) {
+    output = InternedString(std::string_view(stream->value, stream->length));
+    ++stream;
+    return {};
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedString);
+  }
+}
+
+template <>
+template <TokenStream StreamType>
+inline constexpr ParseResult json<InternedString>::validate_tokenstream(StreamType &stream) {
+  return json<std::string>::validate_tokenstream(stream);
+}
+
+template <>
+template <std::output_iterator<char> OutputIterator>
+inline constexpr void json<InternedString>::serialize(InternedString const &object, OutputIterator &output) {
+  *output++ = '"';
+  output = std::copy(object.data(), object.data() + object.size(), output);
+  *output++ = '"';
+}
+
+template <>
+template <std::output_iterator<char> OutputIterator>
+inline constexpr void json<InternedString>::serialize_diff(InternedString const &old_object,
+                                                           InternedString const &object, OutputIterator &output) {
+  serialize(object, output);
+}
+
+template <>
+inline constexpr bool json<InternedString>::equal(InternedString const &object, InternedString const &other) {
+  return object == other;
+}
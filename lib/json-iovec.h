@@ -0,0 +1,125 @@
+#pragma once
+
+#include "json-parsing.h"
+
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <vector>
+
+// Strings at least this long are referenced in place, shorter ones are cheaper to copy than an extra iovec
+#ifndef IOVEC_REFERENCE_MIN_SIZE
+#define IOVEC_REFERENCE_MIN_SIZE 256
+#endif
+
+// Serialization output that collects the document as a list of iovecs for writev/sendmsg. Structural fragments and
+// short values are copied into a scratch buffer, while long strings are referenced where they are stored, so the
+// serialized objects have to stay alive and unchanged until the iovecs have been written.
+//
+//   IovecSink sink;
+//   auto output = sink.output();
+//   json<T>::serialize(object, output);
+//   sink.write_to(fd);
+class IovecSink {
+  // Parts of the scratch buffer are stored as offsets, since the buffer may move while it grows
+  struct Segment {
+    const char *data;
+    size_t offset;
+    size_t length;
+  };
+
+  std::vector<char> scratch;
+  std::vector<Segment> segments;
+
+public:
+  class iterator {
+    IovecSink *sink;
+
+  public:
+    using difference_type = std::ptrdiff_t;
+
+    explicit iterator(IovecSink &sink) : sink(&sink) {}
+
+    iterator &operator*() { return *this; }
+    iterator &operator=(char c) {
+      sink->append(c);
+      return *this;
+    }
+    iterator &operator++() { return *this; }
+    iterator operator++(int) { return *this; }
+
+    void reference(const char *data, size_t length) { sink->reference(data, length); }
+  };
+
+  iterator output() { return iterator(*this); }
+
+  void append(char c) {
+    if (segments.empty() || segments.back().data) {
+      segments.push_back({nullptr, scratch.size(), 0});
+    }
+    scratch.push_back(c);
+    segments.back().length++;
+  }
+
+  void reference(const char *data, size_t length) {
+    if (length < IOVEC_REFERENCE_MIN_SIZE) {
+      for (size_t i = 0; i < length; i++) {
+        append(data[i]);
+      }
+    } else {
+      segments.push_back({data, 0, length});
+    }
+  }
+
+  // Empties the sink but keeps its capacity, so that serializing in a loop does not allocate
+  void clear() {
+    scratch.clear();
+    segments.clear();
+  }
+
+  size_t size() const {
+    size_t size = 0;
+    for (auto const &segment : segments) {
+      size += segment.length;
+    }
+    return size;
+  }
+
+  // Only valid until the sink is written to again
+  std::vector<iovec> iovecs() const {
+    std::vector<iovec> result;
+    result.reserve(segments.size());
+    for (auto const &segment : segments) {
+      const char *data = segment.data ? segment.data : scratch.data() + segment.offset;
+      result.push_back({const_cast<char *>(data), segment.length});
+    }
+    return result;
+  }
+
+  // Writes everything with as few writev calls as IOV_MAX and partial writes allow. Returns false on errors other than
+  // interruptions, with errno set by writev.
+  bool write_to(int fd) const {
+    std::vector<iovec> vectors = iovecs();
+    iovec *next = vectors.data();
+    iovec *end = vectors.data() + vectors.size();
+    while (next != end) {
+      ssize_t written = writev(fd, next, static_cast<int>(std::min<ptrdiff_t>(end - next, IOV_MAX)));
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      size_t remaining = written;
+      while (next != end && remaining >= next->iov_len) {
+        remaining -= next->iov_len;
+        ++next;
+      }
+      if (next != end) {
+        next->iov_base = static_cast<char *>(next->iov_base) + remaining;
+        next->iov_len -= remaining;
+      }
+    }
+    return true;
+  }
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "json-parsing.h"
+
+#include <string>
+#include <unordered_map>
+
+// Objects and containers opt into memoized serialization by providing a version through a function found by
+// argument-dependent lookup, e.g. uint64_t json_version(Comment const &comment). Pointers are versioned by the object
+// they point to.
+template <typename T>
+concept is_versioned = requires(std::remove_pointer_t<T> const &object) {
+  { json_version(object) } -> std::convertible_to<uint64_t>;
+};
+
+template <typename T> inline constexpr char MEMOIZATION_TYPE_TAG = 0;
+
+// Serialized bytes of sub-objects, keyed by their address and type. An entry is reused as long as the object reports
+// the version it had when it was serialized, so versions have to change with every modification. Since a destroyed
+// object's address can be reused, a new object must not start with a version its predecessor had: taking versions from
+// one counter that only ever increases is the simplest way to guarantee both.
+class SerializationCache {
+  struct Key {
+    const void *object;
+    const void *type;
+
+    bool operator==(Key const &other) const = default;
+  };
+
+  struct KeyHash {
+    size_t operator()(Key const &key) const {
+      return std::hash<const void *>()(key.object) ^ (std::hash<const void *>()(key.type) << 1);
+    }
+  };
+
+  struct Entry {
+    uint64_t version;
+    std::string bytes;
+  };
+
+  std::unordered_map<Key, Entry, KeyHash> entries;
+
+  template <typename Buffer> friend class MemoizingOutput;
+
+  template <typename T> static Key key_of(T const &object) {
+    if constexpr (std::is_pointer_v<T>) {
+      return {object, &MEMOIZATION_TYPE_TAG<T>};
+    } else {
+      return {&object, &MEMOIZATION_TYPE_TAG<T>};
+    }
+  }
+
+public:
+  size_t size() const { return entries.size(); }
+  void clear() { entries.clear(); }
+
+  // Drops the entry of an object, which should be done before it is destroyed if versions are not globally unique
+  template <typename T> void erase(T const &object) { entries.erase(key_of(object)); }
+};
+
+// Serialization output into a contiguous buffer (e.g. std::string or std::vector<char>) that splices in the cached
+// bytes of versioned sub-objects that have not changed since they were last serialized. Sub-objects that have changed
+// are serialized as usual and their bytes are taken from the buffer afterwards, so nothing is serialized twice.
+//
+//   auto output = MemoizingOutput(cache, buffer);
+//   json<T>::serialize(object, output);
+template <typename Buffer> class MemoizingOutput {
+  SerializationCache *cache;
+  Buffer *buffer;
+
+public:
+  using difference_type = std::ptrdiff_t;
+
+  MemoizingOutput(SerializationCache &cache, Buffer &buffer) : cache(&cache), buffer(&buffer) {}
+
+  MemoizingOutput &operator*() { return *this; }
+  MemoizingOutput &operator=(char c) {
+    buffer->push_back(c);
+    return *this;
+  }
+  MemoizingOutput &operator++() { return *this; }
+  MemoizingOutput operator++(int) { return *this; }
+
+  template <is_versioned T, std::invocable Serializer> void memoize(T const &object, Serializer &&serialize) {
+    uint64_t version;
+    if constexpr (std::is_pointer_v<T>) {
+      if (!object) {
+        serialize();
+        return;
+      }
+      version = json_version(*object);
+    } else {
+      version = json_version(object);
+    }
+    auto key = SerializationCache::key_of(object);
+    if (auto it = cache->entries.find(key); it != cache->entries.end() && it->second.version == version) {
+      buffer->insert(buffer->end(), it->second.bytes.begin(), it->second.bytes.end());
+      return;
+    }
+
+    size_t begin = buffer->size();
+    serialize();
+    // Serializing may have added entries for nested objects, so the entry is only looked up now
+    auto &entry = cache->entries[key];
+    entry.version = version;
+    entry.bytes.assign(buffer->begin() + begin, buffer->end());
+  }
+};
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "json-parsing.h"
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Inputs smaller than this are always parsed serially, since starting threads would cost more than it saves
+#ifndef PARALLEL_PARSING_MIN_SIZE
+#define PARALLEL_PARSING_MIN_SIZE (1 << 20)
+#endif
+
+// Number of batches each thread should get on average. More batches balance uneven elements better, fewer batches
+// mean less contention on the shared cursor.
+#define PARALLEL_PARSING_BATCHES_PER_THREAD 16
+
+template <class T_Container>
+concept is_parallel_parsable =
+    is_container<T_Container> && !std::is_same_v<typename T_Container::value_type, char> &&
+    !std::is_same_v<typename T_Container::value_type, bool> && requires(T_Container &c, size_t n) {
+      c.resize(n);
+      c[n];
+    };
+
+using ElementSlice = std::pair<const char *, const char *>;
+
+// Finds the element boundaries of a top-level array without tokenizing it. Each slice includes the delimiter following
+// its element (a comma or the closing bracket), so that the tokenizer can terminate numbers at the end of a slice.
+// Strings are skipped as a whole, following the tokenizer in treating every quote as the end of a string. Returns false
+// if the input is not a well-formed top-level array, in which case the caller falls back to serial parsing.
+inline bool split_top_level_array(const char *begin, const char *end, std::vector<ElementSlice> &slices) {
+  const char *cursor = begin;
+  while (cursor != end && isWhitespace(*cursor)) {
+    ++cursor;
+  }
+  if (cursor == end || *cursor != '[') {
+    return false;
+  }
+  ++cursor;
+
+  size_t depth = 0;
+  bool empty = true;
+  const char *elementBegin = cursor;
+  for (; cursor != end; ++cursor) {
+    switch (*cursor) {
+    case '"':
+      cursor = static_cast<const char *>(std::memchr(cursor + 1, '"', end - cursor - 1));
+      if (!cursor) {
+        return false;
+      }
+      empty = false;
+      break;
+    case '{':
+    case '[':
+      ++depth;
+      empty = false;
+      break;
+    case '}':
+    case ']':
+      if (depth > 0) {
+        --depth;
+        break;
+      }
+      if (*cursor != ']' || (empty && !slices.empty())) {
+        return false;
+      }
+      if (!empty) {
+        slices.emplace_back(elementBegin, cursor + 1);
+      }
+      return true;
+    case ',':
+      if (depth == 0) {
+        if (empty) {
+          return false;
+        }
+        slices.emplace_back(elementBegin, cursor + 1);
+        elementBegin = cursor + 1;
+        empty = true;
+      }
+      break;
+    default:
+      if (!isWhitespace(*cursor)) {
+        empty = false;
+      }
+      break;
+    }
+  }
+  return false;
+}
+
+template <typename T> inline bool parse_element_slice(ElementSlice const &slice, T &output) {
+  auto tok = Tokenizer(slice.first, slice.second);
+  if (!parse_field(++tok, output)) {
+    return false;
+  }
+  return tok->type == Token::Type::Comma || tok->type == Token::Type::RBracket;
+}
+
+// Deserializes large documents whose root is an array on several threads. A structural pre-scan splits the array
+// into its elements, which worker threads then claim in batches from a shared cursor and parse directly into their
+// final positions in the output. Small inputs, non-contiguous inputs and roots that are not arrays are parsed serially.
+// If anything goes wrong during the parallel attempt, the input is parsed again serially, so that results and errors
+// are the same as with json<T>.
+template <typename T> struct parallel_json {
+  template <Span Container>
+  static T deserialize(Container const &input, unsigned threads = std::thread::hardware_concurrency()) {
+    T res;
+    deserialize(input, res, threads);
+    return res;
+  }
+
+  template <Span Container>
+  static void deserialize(Container const &input, T &output,
+                          unsigned threads = std::thread::hardware_concurrency()) {
+    if (auto result = try_deserialize(input, output, threads); !result) {
+      throw ParseException(result.error());
+    }
+  }
+
+  template <Span Container>
+  static ParseResult try_deserialize(Container const &input, T &output,
+                                     unsigned threads = std::thread::hardware_concurrency()) {
+    if constexpr (is_parallel_parsable<T> && std::contiguous_iterator<decltype(std::begin(input))>) {
+      size_t size = std::distance(std::begin(input), std::end(input));
+      if (threads > 1 && size >= PARALLEL_PARSING_MIN_SIZE) {
+        const char *begin = &*std::begin(input);
+        if (try_parallel(begin, begin + size, output, threads)) {
+          return {};
+        }
+      }
+    }
+    return json<T>::try_deserialize(input, output);
+  }
+
+private:
+  static bool try_parallel(const char *begin, const char *end, T &output, unsigned threads) {
+    std::vector<ElementSlice> slices;
+    if (!split_top_level_array(begin, end, slices)) {
+      return false;
+    }
+
+    // Like the serial parser, elements are appended to what is already in the container
+    size_t offset = output.size();
+    output.resize(offset + slices.size());
+
+    size_t batch = std::max<size_t>(1, slices.size() / (threads * PARALLEL_PARSING_BATCHES_PER_THREAD));
+    std::atomic<size_t> cursor = 0;
+    std::atomic<bool> failed = false;
+    auto worker = [&]() {
+      for (size_t first = cursor.fetch_add(batch); first < slices.size(); first = cursor.fetch_add(batch)) {
+        size_t last = std::min(first + batch, slices.size());
+        for (size_t i = first; i < last; i++) {
+          if (failed.load(std::memory_order_relaxed) || !parse_element_slice(slices[i], output[offset + i])) {
+            failed = true;
+            return;
+          }
+        }
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; i++) {
+      pool.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : pool) {
+      thread.join();
+    }
+
+    if (failed) {
+      output.resize(offset);
+    }
+    return !failed;
+  }
+};
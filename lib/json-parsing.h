@@ -2,12 +2,21 @@
 
 #include "pp-foreach.h"
 
+#include <algorithm>
+#include <bit>
 #include <charconv>
+#include <cmath>
 #include <concepts>
+#include <cstdint>
 #include <cstring>
+#include <expected>
 #include <iterator>
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
 
 // Test for different compilers' include guards to find out whether special treatment should occur
 #ifdef _GLIBCXX_ARRAY // GCC
@@ -30,6 +39,28 @@
 // Allow separation of template arguments in macro
 #define COMMA ,
 
+// Inside FIELDS(...) and POINTER_FIELDS(...), a field can be written as ENCODED(Encoding, name) to have it parsed and
+// serialized by Encoding instead of by json<T> (see DefaultEncoding for the interface an encoding has to provide)
+#define ENCODED(Encoding, Name) (Encoding, Name)
+
+#define __JSON_PROBE(...) ~, 1
+#define __JSON_CHECK_N(x, n, ...) n
+#define __JSON_CHECK(...) __JSON_CHECK_N(__VA_ARGS__, 0, )
+#define __JSON_IS_PAREN_PROBE(...) __JSON_PROBE()
+#define __JSON_IS_PAREN(x) __JSON_CHECK(__JSON_IS_PAREN_PROBE x)
+#define __JSON_IF_0(t, f) f
+#define __JSON_IF_1(t, f) t
+#define __JSON_IF_EXPANDED(c) __JSON_IF_##c
+#define __JSON_IF(c) __JSON_IF_EXPANDED(c)
+#define __JSON_FIRST(a, b) a
+#define __JSON_SECOND(a, b) b
+#define __JSON_STRINGIFY_EXPANDED(...) #__VA_ARGS__
+#define __JSON_STRINGIFY(...) __JSON_STRINGIFY_EXPANDED(__VA_ARGS__)
+
+#define __FIELD_NAME(Field) __JSON_IF(__JSON_IS_PAREN(Field))(__JSON_SECOND Field, Field)
+#define __FIELD_KEY(Field) __JSON_STRINGIFY(__FIELD_NAME(Field))
+#define __FIELD_ENCODING(Field) __JSON_IF(__JSON_IS_PAREN(Field))(__JSON_FIRST Field, DefaultEncoding)
+
 struct Token {
   enum class Type {
     String,
@@ -53,14 +84,61 @@ struct Token {
   size_t length;
 };
 
+enum class ParseErrorCode : uint8_t {
+  InvalidToken,
+  UnexpectedEnd,
+  ExpectedObject,
+  ExpectedObjectEnd,
+  ExpectedArray,
+  ExpectedString,
+  ExpectedInteger,
+  ExpectedNumber,
+  ExpectedBool,
+  ExpectedStringOrInteger,
+  UnexpectedKey,
+  UnexpectedValue,
+  NumberOutOfRange,
+  ExpectedEnd,
+  InvalidBase64,
+  InputUnavailable,
+  DecompressionFailed,
+  CapacityExceeded
+};
+
+// Compact error description: what went wrong and the byte offset of the offending token in the input
+struct ParseError {
+  ParseErrorCode code;
+  size_t offset;
+};
+
+using ParseResult = std::expected<void, ParseError>;
+
+struct ParseException : public std::runtime_error {
+  ParseError error;
+
+  ParseException(ParseError const &error);
+};
+
+// Forward the error of a failed ParseResult to the caller
+#define __JSON_PROPAGATE(...)                                                                                          \
+  if (auto __result = (__VA_ARGS__); !__result) {                                                                      \
+    return std::unexpected(__result.error());                                                                          \
+  }
+
+// Construct parses into freshly constructed members: containers are appended to and subtypes are newly allocated.
+// Reuse overwrites an object produced by an earlier parse in place, keeping container capacity, string buffers and
+// subtype objects of matching type, so that parsing same-shaped messages in a loop does not allocate.
+enum class ParseMode { Construct, Reuse };
+
+// Parsers only ever advance token streams, so streams may be single-pass and need not be assignable
 template <typename TS>
 concept TokenStream = requires(TS &stream, TS const &const_stream, TS const &other) {
   { const_stream == other } -> std::convertible_to<bool>;
+  { const_stream.offset() } -> std::convertible_to<size_t>;
   { *stream } -> std::convertible_to<Token &>;
   { stream->type } -> std::convertible_to<Token::Type>;
   { stream->value } -> std::convertible_to<const char *>;
   { stream->length } -> std::convertible_to<size_t>;
-  { stream = other } -> std::convertible_to<TS &>;
 };
 
 enum class TokenizerState {
@@ -80,6 +158,14 @@ constexpr inline bool isWhitespace(char c) { return c == ' ' || c == '\t' || c =
 
 constexpr inline bool isValidDelimiter(char c) { return c == ',' || c == '}' || c == ']' || isWhitespace(c); }
 
+// Token streams over contiguous memory additionally give bulk parsers direct access to the unread input
+template <typename TS>
+concept ContiguousTokenStream = TokenStream<TS> && requires(TS &stream, TS const &const_stream, const char *position) {
+  { const_stream.raw_cursor() } -> std::convertible_to<const char *>;
+  { const_stream.raw_end() } -> std::convertible_to<const char *>;
+  stream.seek(position);
+};
+
 template <typename T_Container>
 concept Span = requires(T_Container &c) {
   c.begin();
@@ -89,17 +175,31 @@ concept Span = requires(T_Container &c) {
 template <typename T> struct json {
   template <Span Container> static constexpr T deserialize(Container json);
   template <Span Container> static constexpr void deserialize(Container json, T &output);
+  template <Span Container> static constexpr std::expected<T, ParseError> try_deserialize(Container json);
+  template <Span Container> static constexpr ParseResult try_deserialize(Container json, T &output);
+  template <Span Container> static constexpr void deserialize_reusing(Container const &json, T &output);
+  template <Span Container> static constexpr ParseResult try_deserialize_reusing(Container const &json, T &output);
+  template <Span Container> static constexpr void apply_patch(Container const &patch, T &output);
+  template <Span Container> static constexpr ParseResult try_apply_patch(Container const &patch, T &output);
+  template <Span Container> static constexpr ParseResult validate(Container const &json);
   template <std::output_iterator<char> OutputIterator>
   static constexpr void serialize(T const &object, OutputIterator &output);
+  template <std::output_iterator<char> OutputIterator>
+  static constexpr void serialize_diff(T const &old_object, T const &object, OutputIterator &output);
+  static constexpr bool equal(T const &object, T const &other);
 
-  template <TokenStream StreamType> static constexpr void parse_tokenstream(StreamType &stream, T &output);
+  template <ParseMode Mode = ParseMode::Construct, TokenStream StreamType>
+  static constexpr ParseResult parse_tokenstream(StreamType &stream, T &output);
+  template <TokenStream StreamType> static constexpr ParseResult validate_tokenstream(StreamType &stream);
 };
 
 template <class Container>
 concept is_container = requires() { typename Container::value_type; };
 
 template <is_container T_Container> struct container_json {
-  template <TokenStream StreamType> static constexpr void parse_tokenstream(StreamType &stream, T_Container &output);
+  template <ParseMode Mode = ParseMode::Construct, TokenStream StreamType>
+  static constexpr ParseResult parse_tokenstream(StreamType &stream, T_Container &output);
+  template <TokenStream StreamType> static constexpr ParseResult validate_tokenstream(StreamType &stream);
 };
 
 #define PARTIALLY_SPECIALIZED_JSON(Type)                                                                               \
@@ -112,102 +212,415 @@ template <is_container T_Container> struct container_json {
       return res;                                                                                                      \
     }                                                                                                                  \
     template <Span Container> static constexpr void deserialize(Container json, Type &output) {                        \
-      parse_tokenstream(Tokenizer(std::begin(json)), Tokenizer(std::end(json)), output);                               \
+      if (auto result = try_deserialize(json, output); !result) {                                                      \
+        throw ParseException(result.error());                                                                          \
+      }                                                                                                                \
+    }                                                                                                                  \
+    template <Span Container> static constexpr std::expected<Type, ParseError> try_deserialize(Container json) {       \
+      Type res;                                                                                                        \
+      __JSON_PROPAGATE(try_deserialize(json, res));                                                                    \
+      return res;                                                                                                      \
+    }                                                                                                                  \
+    template <Span Container> static constexpr ParseResult try_deserialize(Container json, Type &output) {             \
+      auto tok = Tokenizer(std::begin(json), std::end(json));                                                          \
+      return parse_field(++tok, output);                                                                               \
+    }                                                                                                                  \
+    template <Span Container> static constexpr void deserialize_reusing(Container const &json, Type &output) {         \
+      if (auto result = try_deserialize_reusing(json, output); !result) {                                              \
+        throw ParseException(result.error());                                                                          \
+      }                                                                                                                \
+    }                                                                                                                  \
+    template <Span Container>                                                                                          \
+    static constexpr ParseResult try_deserialize_reusing(Container const &json, Type &output) {                        \
+      auto tok = Tokenizer(std::begin(json), std::end(json));                                                          \
+      return parse_field<ParseMode::Reuse>(++tok, output);                                                             \
+    }                                                                                                                  \
+    template <Span Container> static constexpr void apply_patch(Container const &patch, Type &output) {                \
+      deserialize_reusing(patch, output);                                                                              \
+    }                                                                                                                  \
+    template <Span Container> static constexpr ParseResult try_apply_patch(Container const &patch, Type &output) {     \
+      return try_deserialize_reusing(patch, output);                                                                   \
+    }                                                                                                                  \
+    template <Span Container> static constexpr ParseResult validate(Container const &json) {                           \
+      auto tok = Tokenizer(std::begin(json), std::end(json));                                                          \
+      __JSON_PROPAGATE(validate_field<Type>(++tok));                                                                   \
+      return expect_end(tok);                                                                                          \
     }                                                                                                                  \
     template <std::output_iterator<char> OutputIterator>                                                               \
     static constexpr void serialize(Type const &object, OutputIterator &output);                                       \
+    template <std::output_iterator<char> OutputIterator>                                                               \
+    static constexpr void serialize_diff(Type const &old_object, Type const &object, OutputIterator &output);          \
+    static constexpr bool equal(Type const &object, Type const &other);                                                \
                                                                                                                        \
-    template <TokenStream StreamType> static constexpr void parse_tokenstream(StreamType &stream, Type &output);       \
+    template <ParseMode Mode = ParseMode::Construct, TokenStream StreamType>                                           \
+    static constexpr ParseResult parse_tokenstream(StreamType &stream, Type &output);                                  \
+    template <TokenStream StreamType> static constexpr ParseResult validate_tokenstream(StreamType &stream);           \
   };
 
 // Needs to be its own function because if constexpr compiles undiscarded branches unless it switches on one of the
 // template parameters
-template <typename T, TokenStream StreamType> inline constexpr void parse_field(StreamType &stream, T &field) {
+template <ParseMode Mode = ParseMode::Construct, typename T, TokenStream StreamType>
+inline constexpr ParseResult parse_field(StreamType &stream, T &field) {
   if constexpr (is_container<T>) {
-    container_json<T>::parse_tokenstream(stream, field);
+    return container_json<T>::template parse_tokenstream<Mode>(stream, field);
+  } else {
+    return json<T>::template parse_tokenstream<Mode>(stream, field);
+  }
+}
+
+// Makes sure a polymorphic pointer points to an object of exactly the given subtype. When reusing, an existing object
+// of that type is kept. A replaced object is only deleted if the base type has a virtual destructor, since otherwise it
+// cannot be deleted safely through the base pointer.
+template <typename InheritingType, ParseMode Mode, typename Base> inline constexpr void prepare_subtype(Base *&output) {
+  if constexpr (Mode == ParseMode::Reuse) {
+    if (output && typeid(*output) == typeid(InheritingType)) {
+      return;
+    }
+    if constexpr (std::has_virtual_destructor_v<Base>) {
+      delete output;
+    }
+  }
+  output = new InheritingType();
+}
+
+// Pointers to objects are null in JSON when they do not point anywhere. A merge patch removes a member by setting it
+// to null, so when reusing, the object is deleted under the same condition as in prepare_subtype. Returns whether the
+// token was a null that has been consumed.
+template <ParseMode Mode, TokenStream StreamType, typename T>
+inline constexpr bool parse_null(StreamType &stream, T &output) {
+  if constexpr (std::is_pointer_v<T>) {
+    if (stream->type == Token::Type::Null) {
+      if constexpr (Mode == ParseMode::Reuse && std::has_virtual_destructor_v<std::remove_pointer_t<T>>) {
+        delete output;
+      }
+      output = nullptr;
+      ++stream;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T, TokenStream StreamType> inline constexpr bool validate_null(StreamType &stream) {
+  if constexpr (std::is_pointer_v<T>) {
+    if (stream->type == Token::Type::Null) {
+      ++stream;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T, TokenStream StreamType> inline constexpr ParseResult validate_field(StreamType &stream) {
+  if constexpr (is_container<T>) {
+    return container_json<T>::validate_tokenstream(stream);
+  } else {
+    return json<T>::validate_tokenstream(stream);
+  }
+}
+
+// Builds the error for the token the stream currently points at. Tokenizer errors and premature ends take precedence
+// over the caller's expectation, since they are the actual cause.
+template <TokenStream StreamType>
+inline constexpr std::unexpected<ParseError> parse_error(StreamType &stream, ParseErrorCode code) {
+  if (stream->type == Token::Type::Error) {
+    code = ParseErrorCode::InvalidToken;
+  } else if (stream->type == Token::Type::End) {
+    code = ParseErrorCode::UnexpectedEnd;
+  }
+  return std::unexpected(ParseError{code, stream.offset()});
+}
+
+template <TokenStream StreamType> inline constexpr ParseResult expect_end(StreamType &stream) {
+  if (stream->type == Token::Type::End) {
+    return {};
   } else {
-    json<T>::parse_tokenstream(stream, field);
+    return parse_error(stream, ParseErrorCode::ExpectedEnd);
   }
 }
 
-#define FIELD_PARSER(Name)                                                                                             \
-  if (key == #Name) {                                                                                                  \
-    parse_field(stream, output.Name);                                                                                  \
+#define FIELD_PARSER(Field)                                                                                            \
+  if (key == __FIELD_KEY(Field)) {                                                                                     \
+    __JSON_PROPAGATE(__FIELD_ENCODING(Field)::template parse_tokenstream<Mode>(stream, output.__FIELD_NAME(Field)));   \
   } else
 
-#define POINTER_FIELD_PARSER(Name)                                                                                     \
-  if (key == #Name) {                                                                                                  \
-    parse_field(stream, output->Name);                                                                                 \
+#define POINTER_FIELD_PARSER(Field)                                                                                    \
+  if (key == __FIELD_KEY(Field)) {                                                                                     \
+    __JSON_PROPAGATE(__FIELD_ENCODING(Field)::template parse_tokenstream<Mode>(stream, output->__FIELD_NAME(Field)));  \
   } else
 
 #define INHERITANCE_PARSER(InheritingType)                                                                             \
   if (key == #InheritingType) {                                                                                        \
-    output = new InheritingType();                                                                                     \
-    json<InheritingType>::parse_tokenstream(stream, *dynamic_cast<InheritingType *>(output));                          \
+    prepare_subtype<InheritingType, Mode>(output);                                                                     \
+    __JSON_PROPAGATE(                                                                                                  \
+        json<InheritingType>::template parse_tokenstream<Mode>(stream, *dynamic_cast<InheritingType *>(output)));      \
   } else
 
-#define PARSE_ENUM_VALUE(Value)                                                                                        \
-  if (value == #Value) {                                                                                               \
-    output = Value;                                                                                                    \
+// Validators check the value of a key against the declared member type without constructing anything
+#define FIELD_VALIDATOR(Field)                                                                                         \
+  if (key == __FIELD_KEY(Field)) {                                                                                     \
+    __JSON_PROPAGATE(__FIELD_ENCODING(Field)::template validate_tokenstream<                                           \
+                     std::remove_cvref_t<decltype(std::declval<ValidatedType &>().__FIELD_NAME(Field))>>(stream));     \
+  } else
+
+#define POINTER_FIELD_VALIDATOR(Field)                                                                                 \
+  if (key == __FIELD_KEY(Field)) {                                                                                     \
+    __JSON_PROPAGATE(__FIELD_ENCODING(Field)::template validate_tokenstream<                                           \
+                     std::remove_cvref_t<decltype(std::declval<ValidatedType &>()->__FIELD_NAME(Field))>>(stream));    \
+  } else
+
+#define INHERITANCE_VALIDATOR(InheritingType)                                                                          \
+  if (key == #InheritingType) {                                                                                        \
+    __JSON_PROPAGATE(json<InheritingType>::validate_tokenstream(stream));                                              \
   } else
 
 #define PARSE_FIELDS(...) FOR_EACH(FIELD_PARSER, __VA_ARGS__)
 #define PARSE_POINTER_FIELDS(...) FOR_EACH(POINTER_FIELD_PARSER, __VA_ARGS__)
 #define PARSE_SUBTYPES(...) FOR_EACH(INHERITANCE_PARSER, __VA_ARGS__)
 
-#define PARSE_ENUM_VALUES(...) FOR_EACH(PARSE_ENUM_VALUE, __VA_ARGS__)
+#define VALIDATE_FIELDS(...) FOR_EACH(FIELD_VALIDATOR, __VA_ARGS__)
+#define VALIDATE_POINTER_FIELDS(...) FOR_EACH(POINTER_FIELD_VALIDATOR, __VA_ARGS__)
+#define VALIDATE_SUBTYPES(...) FOR_EACH(INHERITANCE_VALIDATOR, __VA_ARGS__)
 
-#define __UNEXPECTED_FIELD_ERROR(...) throw std::runtime_error("Unexpected key in " #__VA_ARGS__ " : " + key);
-#define __UNEXPECTED_VALUE_ERROR(...) throw std::runtime_error("Unexpected value in " #__VA_ARGS__ " : " + value);
-#define __OBJECT_NAME_FOR_ERROR_EXPANDED(...) #__VA_ARGS__
-#define __OBJECT_NAME_FOR_ERROR(...) __OBJECT_NAME_FOR_ERROR_EXPANDED(__VA_ARGS__)
+#define ENUM_TABLE_ENTRY(Value) {Value, #Value},
+#define ENUM_TABLE_ENTRIES(...) FOR_EACH(ENUM_TABLE_ENTRY, __VA_ARGS__)
 
-#define TEMPLATED_OBJECT_PARSER(TemplateArgs, ObjectType, ...)                                                         \
-  template <TemplateArgs>                                                                                              \
-  template <TokenStream StreamType>                                                                                    \
-  inline constexpr void json<ObjectType>::parse_tokenstream(StreamType &stream, ObjectType &output) {                  \
+#define __UNEXPECTED_FIELD_ERROR return std::unexpected(ParseError{ParseErrorCode::UnexpectedKey, keyOffset});
+
+// Walks the members of an object, dispatching each key to the chain of key handlers passed as variadic arguments
+#define __OBJECT_TOKENSTREAM_BODY(...)                                                                                 \
     if (stream->type == Token::Type::LBrace) {                                                                         \
       stream++;                                                                                                        \
       if (stream->type == Token::Type::RBrace) {                                                                       \
         ++stream;                                                                                                      \
-        return;                                                                                                        \
+        return {};                                                                                                     \
       }                                                                                                                \
-      std::string key;                                                                                                 \
+      std::string_view key;                                                                                            \
+      size_t keyOffset;                                                                                                \
       bool is_last;                                                                                                    \
       do {                                                                                                             \
-        parse_key(stream, key);                                                                                        \
-        __VA_ARGS__{__UNEXPECTED_FIELD_ERROR(ObjectType)} is_last_in_list(stream, is_last);                            \
+        keyOffset = stream.offset();                                                                                   \
+        __JSON_PROPAGATE(parse_key(stream, key));                                                                      \
+        __VA_ARGS__{__UNEXPECTED_FIELD_ERROR} is_last_in_list(stream, is_last);                                        \
       } while (!is_last);                                                                                              \
       if (stream->type == Token::Type::RBrace) {                                                                       \
         ++stream;                                                                                                      \
+        return {};                                                                                                     \
       } else {                                                                                                         \
-        throw std::runtime_error("Expected right brace, got " + token_type_to_string(stream->type) +                   \
-                                 " while parsing " __OBJECT_NAME_FOR_ERROR(ObjectType) "!");                           \
+        return parse_error(stream, ParseErrorCode::ExpectedObjectEnd);                                                 \
       }                                                                                                                \
     } else {                                                                                                           \
-      throw std::runtime_error("Expected left brace, got " + token_type_to_string(stream->type) +                      \
-                               " while parsing " __OBJECT_NAME_FOR_ERROR(ObjectType) "!");                             \
+      return parse_error(stream, ParseErrorCode::ExpectedObject);                                                      \
+    }
+
+#define TEMPLATED_OBJECT_PARSER(TemplateArgs, ObjectType, ...)                                                         \
+  template <TemplateArgs>                                                                                              \
+  template <ParseMode Mode, TokenStream StreamType>                                                                    \
+  inline constexpr ParseResult json<ObjectType>::parse_tokenstream(StreamType &stream, ObjectType &output) {           \
+    if (parse_null<Mode>(stream, output)) {                                                                            \
+      return {};                                                                                                       \
     }                                                                                                                  \
+    __OBJECT_TOKENSTREAM_BODY(__VA_ARGS__)                                                                             \
   }
 
 #define OBJECT_PARSER(ObjectType, ...) TEMPLATED_OBJECT_PARSER(, ObjectType, __VA_ARGS__)
 
-#define ENUM_PARSER(EnumType, ...)                                                                                     \
-  template <>                                                                                                          \
+#define TEMPLATED_OBJECT_VALIDATOR(TemplateArgs, ObjectType, ...)                                                      \
+  template <TemplateArgs>                                                                                              \
   template <TokenStream StreamType>                                                                                    \
-  inline constexpr void json<EnumType>::parse_tokenstream(StreamType &stream, EnumType &output) {                      \
-    if (stream->type == Token::Type::String) {                                                                         \
-      std::string value = std::string(stream->value, stream->length);                                                  \
-      __VA_ARGS__ { __UNEXPECTED_VALUE_ERROR(ObjectType) }                                                             \
-      ++stream;                                                                                                        \
-    } else if (stream->type == Token::Type::Integer) {                                                                 \
-      output = static_cast<EnumType>(std::atoi(stream->value));                                                        \
-    } else {                                                                                                           \
-      throw std::runtime_error("Expected string or integer, got " + token_type_to_string(stream->type) +               \
-                               "while parsing " __OBJECT_NAME_FOR_ERROR(EnumType) "!");                                \
+  inline constexpr ParseResult json<ObjectType>::validate_tokenstream(StreamType &stream) {                            \
+    using ValidatedType = ObjectType;                                                                                  \
+    if (validate_null<ValidatedType>(stream)) {                                                                        \
+      return {};                                                                                                       \
     }                                                                                                                  \
+    __OBJECT_TOKENSTREAM_BODY(__VA_ARGS__)                                                                             \
+  }
+
+#define OBJECT_VALIDATOR(ObjectType, ...) TEMPLATED_OBJECT_VALIDATOR(, ObjectType, __VA_ARGS__)
+
+// Names of the values of an enum, generated by JSON_ENUM. Lookups in both directions go through open addressing hash
+// tables that are filled at compile time, so neither parsing nor serializing walks the list of values or allocates.
+template <typename EnumType, size_t N> struct EnumTable {
+  static constexpr size_t SLOTS = std::bit_ceil(2 * N + 2);
+  static constexpr size_t EMPTY = N;
+
+  EnumType values[N > 0 ? N : 1] = {};
+  std::string_view names[N > 0 ? N : 1] = {};
+  size_t byName[SLOTS] = {};
+  size_t byValue[SLOTS] = {};
+
+  constexpr EnumTable(std::pair<EnumType, std::string_view> const *entries) {
+    std::fill(byName, byName + SLOTS, EMPTY);
+    std::fill(byValue, byValue + SLOTS, EMPTY);
+    for (size_t i = 0; i < N; i++) {
+      values[i] = entries[i].first;
+      names[i] = entries[i].second;
+      insert(byName, hash(names[i]), i);
+      // Aliases are serialized with the name listed first
+      if (name(values[i]).empty()) {
+        insert(byValue, hash(values[i]), i);
+      }
+    }
+  }
+
+  constexpr const EnumType *find(std::string_view name) const {
+    if constexpr (N == 0) {
+      return nullptr;
+    }
+    for (size_t i = slot(hash(name)); byName[i] != EMPTY; i = (i + 1) % SLOTS) {
+      if (names[byName[i]] == name) {
+        return &values[byName[i]];
+      }
+    }
+    return nullptr;
+  }
+
+  // Returns an empty name for values that are not listed
+  constexpr std::string_view name(EnumType value) const {
+    if constexpr (N == 0) {
+      return {};
+    }
+    for (size_t i = slot(hash(value)); byValue[i] != EMPTY; i = (i + 1) % SLOTS) {
+      if (values[byValue[i]] == value) {
+        return names[byValue[i]];
+      }
+    }
+    return {};
+  }
+
+private:
+  // FNV-1a
+  static constexpr uint64_t hash(std::string_view name) {
+    uint64_t hash = 0xCBF29CE484222325;
+    for (char c : name) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3;
+    }
+    return hash;
+  }
+  static constexpr uint64_t hash(EnumType value) { return static_cast<uint64_t>(value); }
+
+  // Fibonacci hashing spreads consecutive values and the low-entropy bits of short names over the slots
+  static constexpr size_t slot(uint64_t hash) {
+    return (hash * 0x9E3779B97F4A7C15) >> (64 - std::countr_zero(SLOTS));
+  }
+
+  static constexpr void insert(size_t (&table)[SLOTS], uint64_t hash, size_t entry) {
+    size_t i = slot(hash);
+    while (table[i] != EMPTY) {
+      i = (i + 1) % SLOTS;
+    }
+    table[i] = entry;
+  }
+};
+
+template <typename EnumType, size_t N>
+inline constexpr auto make_enum_table(std::pair<EnumType, std::string_view> const (&entries)[N]) {
+  return EnumTable<EnumType, N>(entries);
+}
+
+template <typename EnumType> inline constexpr auto make_enum_table() {
+  return EnumTable<EnumType, 0>(nullptr);
+}
+
+// Specialized by JSON_ENUM
+template <typename EnumType> inline constexpr auto enum_table = make_enum_table<EnumType>();
+
+// Enums are written as the name of their value. Values without a name, like numbers in JSON, are written as numbers.
+template <typename EnumType, size_t N, TokenStream StreamType>
+inline constexpr ParseResult parse_enum(StreamType &stream, EnumTable<EnumType, N> const &table, EnumType &output) {
+  if (stream->type == Token::Type::String) {
+    const EnumType *value = table.find(std::string_view(stream->value, stream->length));
+    if (!value) {
+      return parse_error(stream, ParseErrorCode::UnexpectedValue);
+    }
+    output = *value;
+    ++stream;
+    return {};
+  } else if (stream->type == Token::Type::Integer) {
+    std::underlying_type_t<EnumType> value;
+    __JSON_PROPAGATE(json<std::underlying_type_t<EnumType>>::parse_tokenstream(stream, value));
+    output = static_cast<EnumType>(value);
+    return {};
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedStringOrInteger);
+  }
+}
+
+template <typename EnumType, size_t N, TokenStream StreamType>
+inline constexpr ParseResult validate_enum(StreamType &stream, EnumTable<EnumType, N> const &table) {
+  if (stream->type == Token::Type::String) {
+    if (!table.find(std::string_view(stream->value, stream->length))) {
+      return parse_error(stream, ParseErrorCode::UnexpectedValue);
+    }
+    ++stream;
+    return {};
+  } else if (stream->type == Token::Type::Integer) {
+    return json<std::underlying_type_t<EnumType>>::validate_tokenstream(stream);
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedStringOrInteger);
+  }
+}
+
+template <typename EnumType, size_t N, std::output_iterator<char> OutputIterator>
+inline constexpr void serialize_enum(EnumTable<EnumType, N> const &table, EnumType value, OutputIterator &output) {
+  std::string_view name = table.name(value);
+  if (name.empty()) {
+    json<std::underlying_type_t<EnumType>>::serialize(static_cast<std::underlying_type_t<EnumType>>(value), output);
+  } else {
+    *output++ = '"';
+    output = std::copy(name.begin(), name.end(), output);
+    *output++ = '"';
+  }
+}
+
+#define ENUM_TABLE(EnumType, ...)                                                                                      \
+  template <> inline constexpr auto enum_table<EnumType> = make_enum_table<EnumType>(__VA_OPT__({__VA_ARGS__}));
+
+#define ENUM_PARSER(EnumType)                                                                                          \
+  template <>                                                                                                          \
+  template <ParseMode Mode, TokenStream StreamType>                                                                    \
+  inline constexpr ParseResult json<EnumType>::parse_tokenstream(StreamType &stream, EnumType &output) {               \
+    return parse_enum(stream, enum_table<EnumType>, output);                                                           \
   }
 
+#define ENUM_VALIDATOR(EnumType)                                                                                       \
+  template <>                                                                                                          \
+  template <TokenStream StreamType>                                                                                    \
+  inline constexpr ParseResult json<EnumType>::validate_tokenstream(StreamType &stream) {                              \
+    return validate_enum(stream, enum_table<EnumType>);                                                                \
+  }
+
+#define ENUM_SERIALIZER(EnumType)                                                                                      \
+  template <>                                                                                                          \
+  template <std::output_iterator<char> OutputIterator>                                                                 \
+  inline constexpr void json<EnumType>::serialize(EnumType const &object, OutputIterator &output) {                    \
+    serialize_enum(enum_table<EnumType>, object, output);                                                              \
+  }
+
+// Outputs that can take a reference to a contiguous range of characters instead of a copy of it (see json-iovec.h)
+template <typename T_Iterator>
+concept ReferencingOutputIterator = requires(T_Iterator &it, const char *data, size_t length) {
+  it.reference(data, length);
+};
+
+// Outputs that can splice in the cached serialization of an unchanged object (see json-memoization.h)
+template <typename T_Iterator, typename T>
+concept MemoizingOutputIterator = requires(T_Iterator &it, T const &object, void (*serialize)()) {
+  it.memoize(object, serialize);
+};
+
+// Writes null for a pointer that does not point anywhere and returns whether it did
+template <typename T, std::output_iterator<char> OutputIterator>
+inline constexpr bool serialize_null(T const &object, OutputIterator &output) {
+  if constexpr (std::is_pointer_v<T>) {
+    if (!object) {
+      output = std::copy_n("null", 4, output);
+      return true;
+    }
+  }
+  return false;
+}
+
 struct ContainerSerializer {
   template <std::output_iterator<char> OutputIterator, is_container Container>
   inline static constexpr void serialize(Container const &container, OutputIterator &output);
@@ -215,10 +628,17 @@ struct ContainerSerializer {
 
 template <typename T, std::output_iterator<char> OutputIterator>
 void serialize_field(T const &field, OutputIterator &output) {
-  if constexpr (is_container<T>) {
-    ContainerSerializer::serialize(field, output);
+  auto serialize = [&]() {
+    if constexpr (is_container<T>) {
+      ContainerSerializer::serialize(field, output);
+    } else {
+      json<T>::serialize(field, output);
+    }
+  };
+  if constexpr (MemoizingOutputIterator<OutputIterator, T>) {
+    output.memoize(field, serialize);
   } else {
-    json<T>::serialize(field, output);
+    serialize();
   }
 }
 
@@ -226,19 +646,19 @@ void serialize_field(T const &field, OutputIterator &output) {
   if (!first)                                                                                                          \
     *output++ = ',';                                                                                                   \
   first = false;                                                                                                       \
-  json<const char *>::serialize(#field, output);                                                                       \
+  json<const char *>::serialize(__FIELD_KEY(field), output);                                                           \
   *output++ = ':';                                                                                                     \
   *output++ = ' ';                                                                                                     \
-  serialize_field(object.field, output);
+  __FIELD_ENCODING(field)::serialize(object.__FIELD_NAME(field), output);
 
 #define POINTER_FIELD_SERIALIZER(field)                                                                                \
   if (!first)                                                                                                          \
     *output++ = ',';                                                                                                   \
   first = false;                                                                                                       \
-  json<const char *>::serialize(#field, output);                                                                       \
+  json<const char *>::serialize(__FIELD_KEY(field), output);                                                           \
   *output++ = ':';                                                                                                     \
   *output++ = ' ';                                                                                                     \
-  serialize_field(object->field, output);
+  __FIELD_ENCODING(field)::serialize(object->__FIELD_NAME(field), output);
 
 #define INHERITANCE_SERIALIZER(InheritingType)                                                                         \
   if (dynamic_cast<InheritingType *>(object)) {                                                                        \
@@ -259,6 +679,9 @@ void serialize_field(T const &field, OutputIterator &output) {
   template <TemplateArgs>                                                                                              \
   template <std::output_iterator<char> OutputIterator>                                                                 \
   inline constexpr void json<ObjectType>::serialize(ObjectType const &object, OutputIterator &output) {                \
+    if (serialize_null(object, output)) {                                                                              \
+      return;                                                                                                          \
+    }                                                                                                                  \
     bool first = true;                                                                                                 \
     *output++ = '{';                                                                                                   \
     __VA_ARGS__                                                                                                        \
@@ -269,6 +692,142 @@ void serialize_field(T const &field, OutputIterator &output) {
 
 #define OBJECT_SERIALIZER(ObjectType, ...) TEMPLATED_OBJECT_SERIALIZER(, ObjectType, __VA_ARGS__)
 
+// Structural equality, used by the diff serializer to skip unchanged members
+template <typename T> inline constexpr bool json_equal(T const &object, T const &other) {
+  if constexpr (is_container<T>) {
+    return std::equal(std::begin(object), std::end(object), std::begin(other), std::end(other),
+                      [](auto const &a, auto const &b) { return json_equal(a, b); });
+  } else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    return object == other;
+  } else {
+    return json<T>::equal(object, other);
+  }
+}
+
+// Polymorphic pointers are only comparable member by member if they point to objects of the same type
+template <typename T> inline constexpr bool same_dynamic_type(T const &object, T const &other) {
+  if constexpr (std::is_pointer_v<T>) {
+    return object && other && typeid(*object) == typeid(*other);
+  } else {
+    return true;
+  }
+}
+
+template <typename T> inline constexpr bool identical(T const &object, T const &other) {
+  if constexpr (std::is_pointer_v<T>) {
+    return object == other;
+  } else {
+    return &object == &other;
+  }
+}
+
+template <typename InheritingType, typename Base> inline constexpr bool subtype_equal(Base *object, Base *other) {
+  return !dynamic_cast<InheritingType *>(object) ||
+         json<InheritingType>::equal(*dynamic_cast<InheritingType *>(object), *dynamic_cast<InheritingType *>(other));
+}
+
+#define FIELD_COMPARATOR(field) && json_equal(object.__FIELD_NAME(field), other.__FIELD_NAME(field))
+#define POINTER_FIELD_COMPARATOR(field) && json_equal(object->__FIELD_NAME(field), other->__FIELD_NAME(field))
+#define INHERITANCE_COMPARATOR(InheritingType) && subtype_equal<InheritingType>(object, other)
+
+#define COMPARE_FIELDS(...) FOR_EACH(FIELD_COMPARATOR, __VA_ARGS__)
+#define COMPARE_POINTER_FIELDS(...) FOR_EACH(POINTER_FIELD_COMPARATOR, __VA_ARGS__)
+#define COMPARE_SUBTYPES(...) FOR_EACH(INHERITANCE_COMPARATOR, __PROTECT(__VA_ARGS__))
+
+#define TEMPLATED_OBJECT_COMPARATOR(TemplateArgs, ObjectType, ...)                                                     \
+  template <TemplateArgs>                                                                                              \
+  inline constexpr bool json<ObjectType>::equal(ObjectType const &object, ObjectType const &other) {                   \
+    return identical(object, other) || (same_dynamic_type(object, other) __VA_ARGS__);                                 \
+  }
+
+// Containers and primitives are replaced as a whole, objects are diffed recursively
+template <typename T, std::output_iterator<char> OutputIterator>
+void serialize_field_diff(T const &old_field, T const &field, OutputIterator &output) {
+  if constexpr (is_container<T> || std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+    serialize_field(field, output);
+  } else {
+    json<T>::serialize_diff(old_field, field, output);
+  }
+}
+
+// Encoding of fields without annotation. Other encodings, selected with ENCODED(Encoding, name), provide the same
+// static interface.
+struct DefaultEncoding {
+  template <ParseMode Mode, TokenStream StreamType, typename T>
+  static constexpr ParseResult parse_tokenstream(StreamType &stream, T &field) {
+    return parse_field<Mode>(stream, field);
+  }
+
+  template <typename T, TokenStream StreamType> static constexpr ParseResult validate_tokenstream(StreamType &stream) {
+    return validate_field<T>(stream);
+  }
+
+  template <typename T, std::output_iterator<char> OutputIterator>
+  static constexpr void serialize(T const &field, OutputIterator &output) {
+    serialize_field(field, output);
+  }
+
+  template <typename T, std::output_iterator<char> OutputIterator>
+  static constexpr void serialize_diff(T const &old_field, T const &field, OutputIterator &output) {
+    serialize_field_diff(old_field, field, output);
+  }
+};
+
+#define FIELD_DIFF_SERIALIZER(field)                                                                                   \
+  if (!json_equal(old_object.__FIELD_NAME(field), object.__FIELD_NAME(field))) {                                       \
+    if (!first)                                                                                                        \
+      *output++ = ',';                                                                                                 \
+    first = false;                                                                                                     \
+    json<const char *>::serialize(__FIELD_KEY(field), output);                                                         \
+    *output++ = ':';                                                                                                   \
+    *output++ = ' ';                                                                                                   \
+    __FIELD_ENCODING(field)::serialize_diff(old_object.__FIELD_NAME(field), object.__FIELD_NAME(field), output);       \
+  }
+
+#define POINTER_FIELD_DIFF_SERIALIZER(field)                                                                           \
+  if (!json_equal(old_object->__FIELD_NAME(field), object->__FIELD_NAME(field))) {                                     \
+    if (!first)                                                                                                        \
+      *output++ = ',';                                                                                                 \
+    first = false;                                                                                                     \
+    json<const char *>::serialize(__FIELD_KEY(field), output);                                                         \
+    *output++ = ':';                                                                                                   \
+    *output++ = ' ';                                                                                                   \
+    __FIELD_ENCODING(field)::serialize_diff(old_object->__FIELD_NAME(field), object->__FIELD_NAME(field), output);     \
+  }
+
+#define INHERITANCE_DIFF_SERIALIZER(InheritingType)                                                                    \
+  if (!subtype_equal<InheritingType>(object, old_object)) {                                                            \
+    if (!first)                                                                                                        \
+      *output++ = ',';                                                                                                 \
+    first = false;                                                                                                     \
+    json<const char *>::serialize(#InheritingType, output);                                                            \
+    *output++ = ':';                                                                                                   \
+    *output++ = ' ';                                                                                                   \
+    json<InheritingType>::serialize_diff(*dynamic_cast<InheritingType *>(old_object),                                  \
+                                         *dynamic_cast<InheritingType *>(object), output);                             \
+  }
+
+#define DIFF_FIELDS(...) FOR_EACH(FIELD_DIFF_SERIALIZER, __VA_ARGS__)
+#define DIFF_POINTER_FIELDS(...) FOR_EACH(POINTER_FIELD_DIFF_SERIALIZER, __VA_ARGS__)
+#define DIFF_SUBTYPES(...) FOR_EACH(INHERITANCE_DIFF_SERIALIZER, __PROTECT(__VA_ARGS__))
+
+// Emits an RFC 7386 merge patch that turns old_object into object. If a polymorphic member changed its type, the
+// whole new object is emitted, so that applying the patch replaces it. A member that became null is emitted as null.
+#define TEMPLATED_OBJECT_DIFF_SERIALIZER(TemplateArgs, ObjectType, ...)                                                \
+  template <TemplateArgs>                                                                                              \
+  template <std::output_iterator<char> OutputIterator>                                                                 \
+  inline constexpr void json<ObjectType>::serialize_diff(ObjectType const &old_object, ObjectType const &object,       \
+                                                         OutputIterator &output) {                                     \
+    if (!same_dynamic_type(old_object, object)) {                                                                      \
+      serialize(object, output);                                                                                       \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    bool first = true;                                                                                                 \
+    *output++ = '{';                                                                                                   \
+    __VA_ARGS__                                                                                                        \
+    *output++ = '}';                                                                                                   \
+  }
+
 #define __ONCE(Macro, Arg) Macro(Arg)
 #define __UP_TO_TWICE(Macro, Arg, ...) Macro(Arg) __VA_OPT__(__ONCE(Macro, __VA_ARGS__))
 
@@ -278,6 +837,12 @@ void serialize_field(T const &field, OutputIterator &output) {
 #define __FOR_PARSING(...) __UP_TO_TWICE(__CONCAT_FOR_PARSING, __VA_ARGS__)
 #define __CONCAT_FOR_SERIALIZING(a) __EXPANDED_CONCAT(SERIALIZE_, __PROTECT(a))
 #define __FOR_SERIALIZING(...) __UP_TO_TWICE(__CONCAT_FOR_SERIALIZING, __VA_ARGS__)
+#define __CONCAT_FOR_VALIDATING(a) __EXPANDED_CONCAT(VALIDATE_, __PROTECT(a))
+#define __FOR_VALIDATING(...) __UP_TO_TWICE(__CONCAT_FOR_VALIDATING, __VA_ARGS__)
+#define __CONCAT_FOR_COMPARING(a) __EXPANDED_CONCAT(COMPARE_, __PROTECT(a))
+#define __FOR_COMPARING(...) __UP_TO_TWICE(__CONCAT_FOR_COMPARING, __VA_ARGS__)
+#define __CONCAT_FOR_DIFFING(a) __EXPANDED_CONCAT(DIFF_, __PROTECT(a))
+#define __FOR_DIFFING(...) __UP_TO_TWICE(__CONCAT_FOR_DIFFING, __VA_ARGS__)
 
 #define TEMPLATE_ARGS(...) __VA_ARGS__
 
@@ -285,13 +850,22 @@ void serialize_field(T const &field, OutputIterator &output) {
   TEMPLATED_OBJECT_PARSER(__PROTECT(TemplateArgs),                                                                     \
                           __PROTECT(ObjectType) __VA_OPT__(, __FOR_PARSING(__PROTECT(__VA_ARGS__))))                   \
   TEMPLATED_OBJECT_SERIALIZER(__PROTECT(TemplateArgs),                                                                 \
-                              __PROTECT(ObjectType) __VA_OPT__(, __FOR_SERIALIZING(__PROTECT(__VA_ARGS__))))
+                              __PROTECT(ObjectType) __VA_OPT__(, __FOR_SERIALIZING(__PROTECT(__VA_ARGS__))))           \
+  TEMPLATED_OBJECT_VALIDATOR(__PROTECT(TemplateArgs),                                                                  \
+                             __PROTECT(ObjectType) __VA_OPT__(, __FOR_VALIDATING(__PROTECT(__VA_ARGS__))))             \
+  TEMPLATED_OBJECT_COMPARATOR(__PROTECT(TemplateArgs),                                                                 \
+                              __PROTECT(ObjectType) __VA_OPT__(, __FOR_COMPARING(__PROTECT(__VA_ARGS__))))             \
+  TEMPLATED_OBJECT_DIFF_SERIALIZER(__PROTECT(TemplateArgs),                                                            \
+                                   __PROTECT(ObjectType) __VA_OPT__(, __FOR_DIFFING(__PROTECT(__VA_ARGS__))))
 
 #define JSON(ObjectType, ...)                                                                                          \
   TEMPLATED_JSON(TEMPLATE_ARGS(), __PROTECT(ObjectType) __VA_OPT__(, __PROTECT(__VA_ARGS__)))
 
 #define JSON_ENUM(EnumType, ...)                                                                                       \
-  ENUM_PARSER(EnumType __VA_OPT__(, PARSE_ENUM_VALUES(__VA_ARGS__))) // TODO: Implement serializer
+  ENUM_TABLE(EnumType __VA_OPT__(, ENUM_TABLE_ENTRIES(__VA_ARGS__)))                                                   \
+  ENUM_PARSER(EnumType)                                                                                                \
+  ENUM_VALIDATOR(EnumType)                                                                                             \
+  ENUM_SERIALIZER(EnumType)
 
 // +-----------------+
 // | IMPLEMENTATIONS |
@@ -299,42 +873,74 @@ void serialize_field(T const &field, OutputIterator &output) {
 
 // Deserialization
 
-inline constexpr std::string token_type_to_string(Token::Type type) {
-  switch (type) {
-  case Token::Type::String:
-    return "String";
-  case Token::Type::Integer:
-    return "Integer";
-  case Token::Type::Float:
-    return "Float";
-  case Token::Type::Colon:
-    return "Colon";
-  case Token::Type::Comma:
-    return "Comma";
-  case Token::Type::LBrace:
-    return "LBrace";
-  case Token::Type::RBrace:
-    return "RBrace";
-  case Token::Type::LBracket:
-    return "LBracket";
-  case Token::Type::RBracket:
-    return "RBracket";
-  case Token::Type::True:
-    return "True";
-  case Token::Type::False:
-    return "False";
-  case Token::Type::Null:
-    return "Null";
-  case Token::Type::End:
-    return "End";
-  case Token::Type::Error:
-    return "Error";
+inline constexpr std::string parse_error_code_to_string(ParseErrorCode code) {
+  switch (code) {
+  case ParseErrorCode::InvalidToken:
+    return "Invalid token";
+  case ParseErrorCode::UnexpectedEnd:
+    return "Unexpected end of input";
+  case ParseErrorCode::ExpectedObject:
+    return "Expected left brace";
+  case ParseErrorCode::ExpectedObjectEnd:
+    return "Expected right brace";
+  case ParseErrorCode::ExpectedArray:
+    return "Expected '['";
+  case ParseErrorCode::ExpectedString:
+    return "Expected String";
+  case ParseErrorCode::ExpectedInteger:
+    return "Expected Integer";
+  case ParseErrorCode::ExpectedNumber:
+    return "Expected Integer or Float";
+  case ParseErrorCode::ExpectedBool:
+    return "Expected True or False";
+  case ParseErrorCode::ExpectedStringOrInteger:
+    return "Expected String or Integer";
+  case ParseErrorCode::UnexpectedKey:
+    return "Unexpected key";
+  case ParseErrorCode::UnexpectedValue:
+    return "Unexpected value";
+  case ParseErrorCode::NumberOutOfRange:
+    return "Number out of range";
+  case ParseErrorCode::ExpectedEnd:
+    return "Expected end of input";
+  case ParseErrorCode::InvalidBase64:
+    return "Invalid base64";
+  case ParseErrorCode::InputUnavailable:
+    return "Input unavailable";
+  case ParseErrorCode::DecompressionFailed:
+    return "Decompression failed";
+  case ParseErrorCode::CapacityExceeded:
+    return "Capacity exceeded";
   default:
-    return "Unknown";
+    return "Unknown error";
+  }
+}
+
+inline ParseException::ParseException(ParseError const &error)
+    : std::runtime_error(parse_error_code_to_string(error.code) + " at offset " + std::to_string(error.offset) + "!"),
+      error(error) {}
+
+// Checks a number token against a type. Returns invalid_argument for malformed numbers (e.g. "-") and
+// result_out_of_range for well-formed numbers the type cannot hold, including negative numbers for unsigned types.
+template <typename T> inline constexpr std::errc check_number(const char *first, const char *last) {
+  T value;
+  auto [end, error] = std::from_chars(first, last, value);
+  if (error == std::errc() && end != last) {
+    return std::errc::invalid_argument;
+  }
+  if constexpr (std::is_unsigned_v<T>) {
+    if (error == std::errc::invalid_argument && last - first > 1 && *first == '-') {
+      auto [magnitudeEnd, magnitudeError] = std::from_chars(first + 1, last, value);
+      if (magnitudeEnd != last || (magnitudeError != std::errc() && magnitudeError != std::errc::result_out_of_range)) {
+        return std::errc::invalid_argument;
+      }
+      return magnitudeError == std::errc() && value == 0 ? std::errc() : std::errc::result_out_of_range;
+    }
   }
+  return error;
 }
 
-#define JSON_IMPL_PRIMITIVE(PrimitiveType, TokenType, Parser)                                                          \
+#define JSON_IMPL_PRIMITIVE(PrimitiveType, TokenType, ErrorCode, Parser)                                               \
   template <>                                                                                                          \
   template <std::output_iterator<char> OutputIterator>                                                                 \
   inline constexpr void json<PrimitiveType>::serialize(PrimitiveType const &object, OutputIterator &output) {          \
@@ -347,62 +953,106 @@ inline constexpr std::string token_type_to_string(Token::Type type) {
   }                                                                                                                    \
                                                                                                                        \
   template <>                                                                                                          \
-  template <TokenStream StreamType>                                                                                    \
-  inline constexpr void json<PrimitiveType>::parse_tokenstream(StreamType &stream, PrimitiveType &output) {            \
+  template <ParseMode Mode, TokenStream StreamType>                                                                    \
+  inline constexpr ParseResult json<PrimitiveType>::parse_tokenstream(StreamType &stream, PrimitiveType &output) {     \
     if (stream->type == Token::Type::TokenType) {                                                                      \
       output = Parser;                                                                                                 \
       ++stream;                                                                                                        \
+      return {};                                                                                                       \
+    } else {                                                                                                           \
+      return parse_error(stream, ParseErrorCode::ErrorCode);                                                           \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  template <>                                                                                                          \
+  template <TokenStream StreamType>                                                                                    \
+  inline constexpr ParseResult json<PrimitiveType>::validate_tokenstream(StreamType &stream) {                         \
+    if (stream->type == Token::Type::TokenType) {                                                                      \
+      std::errc error = check_number<PrimitiveType>(stream->value, stream->value + stream->length);                    \
+      if (error == std::errc::result_out_of_range) {                                                                   \
+        return parse_error(stream, ParseErrorCode::NumberOutOfRange);                                                  \
+      } else if (error != std::errc()) {                                                                               \
+        return parse_error(stream, ParseErrorCode::ErrorCode);                                                         \
+      }                                                                                                                \
+      ++stream;                                                                                                        \
+      return {};                                                                                                       \
     } else {                                                                                                           \
-      throw std::runtime_error("Expected " #TokenType ", got " + token_type_to_string(stream->type) + "!");            \
+      return parse_error(stream, ParseErrorCode::ErrorCode);                                                           \
     }                                                                                                                  \
   }
 
 #ifdef __JSON_INTTYPES
-JSON_IMPL_PRIMITIVE(uint8_t, Integer, static_cast<uint8_t>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(uint16_t, Integer, static_cast<uint16_t>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(uint32_t, Integer, static_cast<uint32_t>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(uint64_t, Integer, static_cast<uint64_t>(std::atol(stream->value)))
-JSON_IMPL_PRIMITIVE(int8_t, Integer, static_cast<int8_t>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(int16_t, Integer, static_cast<int16_t>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(int32_t, Integer, static_cast<int32_t>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(int64_t, Integer, static_cast<int64_t>(std::atol(stream->value)))
+JSON_IMPL_PRIMITIVE(uint8_t, Integer, ExpectedInteger, static_cast<uint8_t>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(uint16_t, Integer, ExpectedInteger, static_cast<uint16_t>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(uint32_t, Integer, ExpectedInteger, static_cast<uint32_t>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(uint64_t, Integer, ExpectedInteger, std::strtoull(stream->value, nullptr, 10))
+JSON_IMPL_PRIMITIVE(int8_t, Integer, ExpectedInteger, static_cast<int8_t>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(int16_t, Integer, ExpectedInteger, static_cast<int16_t>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(int32_t, Integer, ExpectedInteger, static_cast<int32_t>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(int64_t, Integer, ExpectedInteger, static_cast<int64_t>(std::atol(stream->value)))
 #else
-JSON_IMPL_PRIMITIVE(char, Integer, static_cast<char>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(short, Integer, static_cast<short>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(int, Integer, static_cast<int>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(long, Integer, static_cast<long>(std::atol(stream->value)))
-JSON_IMPL_PRIMITIVE(long long, Integer, static_cast<long>(std::atol(stream->value)))
-JSON_IMPL_PRIMITIVE(unsigned char, Integer, static_cast<unsigned char>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(unsigned short, Integer, static_cast<unsigned short>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(unsigned int, Integer, static_cast<unsigned int>(std::atoi(stream->value)))
-JSON_IMPL_PRIMITIVE(unsigned long, Integer, static_cast<unsigned long>(std::atol(stream->value)))
-JSON_IMPL_PRIMITIVE(unsigned long long, Integer, static_cast<unsigned long>(std::atol(stream->value)))
+JSON_IMPL_PRIMITIVE(char, Integer, ExpectedInteger, static_cast<char>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(short, Integer, ExpectedInteger, static_cast<short>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(int, Integer, ExpectedInteger, static_cast<int>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(long, Integer, ExpectedInteger, static_cast<long>(std::atol(stream->value)))
+JSON_IMPL_PRIMITIVE(long long, Integer, ExpectedInteger, static_cast<long>(std::atol(stream->value)))
+JSON_IMPL_PRIMITIVE(unsigned char, Integer, ExpectedInteger, static_cast<unsigned char>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(unsigned short, Integer, ExpectedInteger, static_cast<unsigned short>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(unsigned int, Integer, ExpectedInteger, static_cast<unsigned int>(std::atoi(stream->value)))
+JSON_IMPL_PRIMITIVE(unsigned long, Integer, ExpectedInteger, std::strtoul(stream->value, nullptr, 10))
+JSON_IMPL_PRIMITIVE(unsigned long long, Integer, ExpectedInteger, std::strtoull(stream->value, nullptr, 10))
 #endif
-JSON_IMPL_PRIMITIVE(float, Float || stream->type == Token::Type::Integer, static_cast<float>(std::atof(stream->value)))
-JSON_IMPL_PRIMITIVE(double, Float || stream->type == Token::Type::Integer, std::atof(stream->value))
+JSON_IMPL_PRIMITIVE(float, Float || stream->type == Token::Type::Integer, ExpectedNumber,
+                    static_cast<float>(std::atof(stream->value)))
+JSON_IMPL_PRIMITIVE(double, Float || stream->type == Token::Type::Integer, ExpectedNumber, std::atof(stream->value))
 
 template <>
-template <TokenStream StreamType>
-inline constexpr void json<std::string>::parse_tokenstream(StreamType &stream, std::string &output) {
+template <ParseMode Mode, TokenStream StreamType>
+inline constexpr ParseResult json<std::string>::parse_tokenstream(StreamType &stream, std::string &output) {
   if (stream->type == Token::Type::String) {
-    output = std::string(stream->value, stream->length);
+    output.assign(stream->value, stream->length);
     ++stream;
+    return {};
   } else {
-    throw std::runtime_error("Expected String, got " + token_type_to_string(stream->type) + "!");
+    return parse_error(stream, ParseErrorCode::ExpectedString);
   }
 }
 
 template <>
 template <TokenStream StreamType>
-inline constexpr void json<bool>::parse_tokenstream(StreamType &stream, bool &output) {
+inline constexpr ParseResult json<std::string>::validate_tokenstream(StreamType &stream) {
+  if (stream->type == Token::Type::String) {
+    ++stream;
+    return {};
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedString);
+  }
+}
+
+template <>
+template <ParseMode Mode, TokenStream StreamType>
+inline constexpr ParseResult json<bool>::parse_tokenstream(StreamType &stream, bool &output) {
   if (stream->type == Token::Type::True) {
     output = true;
     ++stream;
+    return {};
   } else if (stream->type == Token::Type::False) {
     output = false;
     ++stream;
+    return {};
   } else {
-    throw std::runtime_error("Expected True or False, got " + token_type_to_string(stream->type) + "!");
+    return parse_error(stream, ParseErrorCode::ExpectedBool);
+  }
+}
+
+template <>
+template <TokenStream StreamType>
+inline constexpr ParseResult json<bool>::validate_tokenstream(StreamType &stream) {
+  if (stream->type == Token::Type::True || stream->type == Token::Type::False) {
+    ++stream;
+    return {};
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedBool);
   }
 }
 
@@ -411,16 +1061,27 @@ template <typename T, size_t n> PARTIALLY_SPECIALIZED_JSON(std::array<T COMMA n>
 template <size_t n> PARTIALLY_SPECIALIZED_JSON(std::array<char COMMA n>);
 
 template <size_t n> struct container_json<std::array<char, n>> {
-  template <TokenStream StreamType>
-  inline constexpr void parse_tokenstream(StreamType &stream, std::array<char, n> &output) {
+  template <ParseMode Mode = ParseMode::Construct, TokenStream StreamType>
+  static inline constexpr ParseResult parse_tokenstream(StreamType &stream, std::array<char, n> &output) {
     if (stream->type == Token::Type::String) {
-      memcpy(output.data(), stream->value, std::min(n, stream->length));
+      if (stream->length > n) {
+        return parse_error(stream, ParseErrorCode::CapacityExceeded);
+      }
+      memcpy(output.data(), stream->value, stream->length);
       if (stream->length < output.size())
         output[stream->length] = 0;
       ++stream;
+      return {};
     } else {
-      throw std::runtime_error("Expected String, got " + token_type_to_string(stream->type) + "!");
+      return parse_error(stream, ParseErrorCode::ExpectedString);
+    }
+  }
+
+  template <TokenStream StreamType> static inline constexpr ParseResult validate_tokenstream(StreamType &stream) {
+    if (stream->type == Token::Type::String && stream->length > n) {
+      return parse_error(stream, ParseErrorCode::CapacityExceeded);
     }
+    return json<std::string>::validate_tokenstream(stream);
   }
 };
 #endif
@@ -428,91 +1089,343 @@ template <size_t n> struct container_json<std::array<char, n>> {
 template <class T_Iterator, typename T>
 concept ContainerInserter = requires(T_Iterator &it, T const &value) { *(it++) = value; };
 
+// Parses the remaining elements of an array up to and including the closing bracket
+template <TokenStream StreamType, typename T, ContainerInserter<T> T_It>
+inline constexpr ParseResult parse_tokenstream_elements(StreamType &stream, T_It &output_it) {
+  while (stream->type != Token::Type::RBracket) {
+    T value;
+    __JSON_PROPAGATE(parse_field(stream, value));
+    *(output_it++) = std::move(value);
+    if (stream->type == Token::Type::Comma) {
+      stream++;
+    }
+  }
+  ++stream;
+  return {};
+}
+
 template <TokenStream StreamType, typename T, ContainerInserter<T> T_It>
-inline constexpr void parse_tokenstream_insertion(StreamType &stream, T_It &output_it) {
+inline constexpr ParseResult parse_tokenstream_insertion(StreamType &stream, T_It &output_it) {
+  if (stream->type == Token::Type::LBracket) {
+    stream++;
+    return parse_tokenstream_elements<StreamType, T, T_It>(stream, output_it);
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedArray);
+  }
+}
+
+// Converts eight ASCII digits, the first one in the lowest byte, with three multiplications (SWAR)
+inline constexpr uint32_t parse_eight_digits(uint64_t chunk) {
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FF) * 0x000F424000000064) +
+           (((chunk >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >>
+          32;
+  return static_cast<uint32_t>(chunk);
+}
+
+// Branch-light parsing of integers with up to seven digits: the digits are located in an eight byte load with a bit
+// mask, padded with leading zeros and converted at once. Longer numbers, numbers close to the end of the input and
+// malformed input go through std::from_chars.
+template <std::integral T> inline std::from_chars_result parse_integer(const char *first, const char *last, T &value) {
+  const char *cursor = first;
+  bool negative = false;
+  if constexpr (std::is_signed_v<T>) {
+    if (cursor != last && *cursor == '-') {
+      negative = true;
+      cursor++;
+    }
+  }
+  if (std::endian::native != std::endian::little || last - cursor < 8) {
+    return std::from_chars(first, last, value);
+  }
+
+  uint64_t chunk;
+  std::memcpy(&chunk, cursor, 8);
+  // A byte is a digit if its high nibble is 3 and its low nibble does not overflow when adding 6
+  uint64_t nonDigits = ((chunk & 0xF0F0F0F0F0F0F0F0) ^ 0x3030303030303030) |
+                       (((chunk & 0x0F0F0F0F0F0F0F0F) + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0);
+  int digits = std::countr_zero(nonDigits) / 8;
+  if (digits == 0 || digits == 8) {
+    return std::from_chars(first, last, value);
+  }
+
+  chunk = (chunk << (8 - digits) * 8) | (0x3030303030303030 >> digits * 8);
+  int64_t number = parse_eight_digits(chunk);
+  if (negative) {
+    number = -number;
+  }
+  if (!std::in_range<T>(number)) {
+    return {first, std::errc::result_out_of_range};
+  }
+  value = static_cast<T>(number);
+  return {cursor + digits, std::errc()};
+}
+
+// Only accepts numbers that start like a number token, since std::from_chars also reads nan, inf and .5, which the
+// tokenizer rejects
+template <typename T> inline std::from_chars_result parse_number(const char *first, const char *last, T &value) {
+  if (first == last || !(isDigit(*first) || (*first == '-' && last - first > 1 && isDigit(first[1])))) {
+    return {first, std::errc::invalid_argument};
+  }
+  if constexpr (std::is_same_v<T, float>) {
+    // Rounded via double like the tokenizer path, which converts with std::atof
+    double number;
+    auto result = parse_number(first, last, number);
+    if (result.ec == std::errc() && std::abs(number) > std::numeric_limits<float>::max()) {
+      return {first, std::errc::result_out_of_range};
+    }
+    value = static_cast<float>(number);
+    return result;
+  } else if constexpr (std::is_floating_point_v<T>) {
+    // The tokenizer does not accept exponents, so neither does the bulk parser
+    return std::from_chars(first, last, value, std::chars_format::fixed);
+  } else {
+    return parse_integer(first, last, value);
+  }
+}
+
+// Parses the body of a numeric array straight from the input, behind the opening bracket. The closing bracket is
+// located first (memchr is vectorized) so that the container can be reserved for the number of commas up to it.
+// Returns the position behind the closing bracket and sets complete, or stops at the first element the bulk parser
+// does not handle and returns its position, leaving it and the rest of the array to the tokenizer.
+template <typename T_Container>
+inline const char *parse_numbers_in_bulk(const char *cursor, const char *end, T_Container &output, bool &complete) {
+  complete = false;
+  const char *closing = static_cast<const char *>(std::memchr(cursor, ']', end - cursor));
+  if (!closing) {
+    return cursor;
+  }
+  if constexpr (requires { output.reserve(0); }) {
+    output.reserve(output.size() + std::count(cursor, closing, ',') + 1);
+  }
+
+  while (cursor != closing && isWhitespace(*cursor)) {
+    cursor++;
+  }
+  while (cursor != closing) {
+    typename T_Container::value_type value;
+    auto result = parse_number(cursor, closing, value);
+    if (result.ec != std::errc()) {
+      return cursor;
+    }
+    const char *next = result.ptr;
+    while (next != closing && isWhitespace(*next)) {
+      next++;
+    }
+    if (next != closing) {
+      if (*next != ',') {
+        return cursor;
+      }
+      next++;
+      while (next != closing && isWhitespace(*next)) {
+        next++;
+      }
+      if (next == closing) {
+        // Trailing comma, leave it to the tokenizer as well
+        output.push_back(value);
+        return next;
+      }
+    }
+    output.push_back(value);
+    cursor = next;
+  }
+  complete = true;
+  return closing + 1;
+}
+
+template <TokenStream StreamType, typename T_Container>
+inline constexpr ParseResult parse_tokenstream_numbers(StreamType &stream, T_Container &output) {
+  if (stream->type == Token::Type::LBracket) {
+    bool complete;
+    stream.seek(parse_numbers_in_bulk(stream.raw_cursor(), stream.raw_end(), output, complete));
+    ++stream;
+    if (complete) {
+      return {};
+    }
+    auto it = std::back_inserter(output);
+    return parse_tokenstream_elements<StreamType, typename T_Container::value_type, decltype(it)>(stream, it);
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedArray);
+  }
+}
+
+// Overwrites the existing elements of a container in place, appends as needed and drops the surplus, so that both the
+// container's capacity and the resources of its elements are kept
+template <TokenStream StreamType, typename T_Container>
+inline constexpr ParseResult parse_tokenstream_refill(StreamType &stream, T_Container &output) {
   if (stream->type == Token::Type::LBracket) {
     stream++;
+    auto it = output.begin();
     while (stream->type != Token::Type::RBracket) {
-      T value;
-      parse_field(stream, value);
-      *(output_it++) = value;
+      if (it == output.end()) {
+        output.emplace_back();
+        it = std::prev(output.end());
+      }
+      __JSON_PROPAGATE(parse_field<ParseMode::Reuse>(stream, *it));
+      ++it;
       if (stream->type == Token::Type::Comma) {
         stream++;
       }
     }
+    output.erase(it, output.end());
     ++stream;
+    return {};
   } else {
-    throw std::runtime_error("Expected '[', got " + token_type_to_string(stream->type) + "!");
+    return parse_error(stream, ParseErrorCode::ExpectedArray);
   }
 }
 
-#ifdef __JSON_ARRAYS
-
-template <typename T, size_t n> class ArrayInserter {
-  size_t index;
-  std::array<T, n> &referencedArray;
-
-public:
-  ArrayInserter(ArrayInserter<T, n> const &other) : index(other.index), referencedArray(other.referencedArray) {}
-  ArrayInserter(std::array<T, n> &reference) : index(0), referencedArray(reference) {}
+template <TokenStream StreamType, typename T>
+inline constexpr ParseResult validate_tokenstream_elements(StreamType &stream) {
+  if (stream->type == Token::Type::LBracket) {
+    stream++;
+    while (stream->type != Token::Type::RBracket) {
+      __JSON_PROPAGATE(validate_field<T>(stream));
+      if (stream->type == Token::Type::Comma) {
+        stream++;
+      }
+    }
+    ++stream;
+    return {};
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedArray);
+  }
+}
 
-  inline constexpr T &operator*() { return referencedArray[index]; }
-  inline constexpr ArrayInserter operator++() {
-    index++;
-    return {*this};
+// Parses an array into storage for capacity elements, which are parsed in place so that nothing is allocated on behalf
+// of the container. Construct appends behind the first count elements, Reuse overwrites from the front and keeps the
+// resources of the first count elements. Afterwards, count is the number of elements in use. An element that does not
+// fit is reported as CapacityExceeded at its position.
+template <ParseMode Mode, TokenStream StreamType, typename T>
+inline constexpr ParseResult parse_tokenstream_bounded(StreamType &stream, T *elements, size_t capacity,
+                                                       size_t &count) {
+  if (stream->type == Token::Type::LBracket) {
+    stream++;
+    size_t reusable = Mode == ParseMode::Reuse ? count : 0;
+    if constexpr (Mode == ParseMode::Reuse) {
+      count = 0;
+    }
+    while (stream->type != Token::Type::RBracket) {
+      if (count == capacity) {
+        return parse_error(stream, ParseErrorCode::CapacityExceeded);
+      }
+      if (count < reusable) {
+        __JSON_PROPAGATE(parse_field<ParseMode::Reuse>(stream, elements[count]));
+      } else {
+        elements[count] = T();
+        __JSON_PROPAGATE(parse_field(stream, elements[count]));
+      }
+      count++;
+      if (stream->type == Token::Type::Comma) {
+        stream++;
+      }
+    }
+    ++stream;
+    return {};
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedArray);
   }
-  inline constexpr ArrayInserter operator++(int) {
-    auto tmp = ArrayInserter(*this);
-    index++;
-    return tmp;
+}
+
+template <TokenStream StreamType, typename T>
+inline constexpr ParseResult validate_tokenstream_bounded(StreamType &stream, size_t capacity) {
+  if (stream->type == Token::Type::LBracket) {
+    stream++;
+    for (size_t count = 0; stream->type != Token::Type::RBracket; count++) {
+      if (count == capacity) {
+        return parse_error(stream, ParseErrorCode::CapacityExceeded);
+      }
+      __JSON_PROPAGATE(validate_field<T>(stream));
+      if (stream->type == Token::Type::Comma) {
+        stream++;
+      }
+    }
+    ++stream;
+    return {};
+  } else {
+    return parse_error(stream, ParseErrorCode::ExpectedArray);
   }
-};
+}
 
-static_assert(ContainerInserter<ArrayInserter<int, 8>, int>, "Simple int array asserter does not work properly!");
+#ifdef __JSON_ARRAYS
 
+// Arrays are filled from the front, elements missing from the input keep their values
 template <typename T, size_t n> struct container_json<std::array<T, n>> {
-  template <TokenStream StreamType>
-  static constexpr void parse_tokenstream(StreamType &stream, std::array<T, n> &output) {
-    auto it = ArrayInserter<T, n>(output);
-    parse_tokenstream_insertion<StreamType, T, ArrayInserter<T, n>>(stream, it);
+  template <ParseMode Mode = ParseMode::Construct, TokenStream StreamType>
+  static constexpr ParseResult parse_tokenstream(StreamType &stream, std::array<T, n> &output) {
+    size_t count = Mode == ParseMode::Reuse ? n : 0;
+    return parse_tokenstream_bounded<Mode>(stream, output.data(), n, count);
+  }
+
+  template <TokenStream StreamType> static constexpr ParseResult validate_tokenstream(StreamType &stream) {
+    return validate_tokenstream_bounded<StreamType, T>(stream, n);
   }
 };
 
 #endif
 
+template <>
+template <ParseMode Mode, TokenStream StreamType>
+inline constexpr ParseResult container_json<std::string>::parse_tokenstream(StreamType &stream, std::string &output) {
+  return json<std::string>::parse_tokenstream<Mode>(stream, output);
+}
+
 template <>
 template <TokenStream StreamType>
-inline constexpr void container_json<std::string>::parse_tokenstream(StreamType &stream, std::string &output) {
-  if (stream->type == Token::Type::String) {
-    output = std::string(stream->value, stream->length);
-    ++stream;
-  } else {
-    throw std::runtime_error("Expected String, got " + token_type_to_string(stream->type) + "!");
-  }
+inline constexpr ParseResult container_json<std::string>::validate_tokenstream(StreamType &stream) {
+  return json<std::string>::validate_tokenstream(stream);
 }
 
 template <class T_Container>
 concept has_back_inserter = requires(T_Container &c, typename T_Container::value_type const &v) { c.push_back(v); };
 
+template <class T_Container>
+concept is_refillable = requires(T_Container &c) {
+  c.emplace_back();
+  c.erase(c.begin(), c.end());
+};
+
+template <class T_Container>
+concept is_numeric_container = has_back_inserter<T_Container> &&
+                               std::is_arithmetic_v<typename T_Container::value_type> &&
+                               !std::is_same_v<typename T_Container::value_type, bool> &&
+                               !std::is_same_v<typename T_Container::value_type, char>;
+
 template <is_container T_Container>
-template <TokenStream StreamType>
-inline constexpr void container_json<T_Container>::parse_tokenstream(StreamType &stream, T_Container &output) {
-  if constexpr (has_back_inserter<T_Container>) {
+template <ParseMode Mode, TokenStream StreamType>
+inline constexpr ParseResult container_json<T_Container>::parse_tokenstream(StreamType &stream, T_Container &output) {
+  if constexpr (is_numeric_container<T_Container> && ContiguousTokenStream<StreamType>) {
+    // Numbers own no resources, so reusing a container just means keeping its capacity
+    if constexpr (Mode == ParseMode::Reuse) {
+      output.clear();
+    }
+    return parse_tokenstream_numbers(stream, output);
+  } else if constexpr (Mode == ParseMode::Reuse && is_refillable<T_Container>) {
+    return parse_tokenstream_refill(stream, output);
+  } else if constexpr (has_back_inserter<T_Container>) {
     auto it = std::back_inserter(output);
-    parse_tokenstream_insertion<StreamType, typename T_Container::value_type, decltype(it)>(stream, it);
+    return parse_tokenstream_insertion<StreamType, typename T_Container::value_type, decltype(it)>(stream, it);
   } else {
     static_assert(false, "Tried to parse container type without valid handling!");
   }
 }
 
-template <TokenStream StreamType> inline constexpr void parse_key(StreamType &stream, std::string &key) {
+template <is_container T_Container>
+template <TokenStream StreamType>
+inline constexpr ParseResult container_json<T_Container>::validate_tokenstream(StreamType &stream) {
+  return validate_tokenstream_elements<StreamType, typename T_Container::value_type>(stream);
+}
+
+template <TokenStream StreamType> inline constexpr ParseResult parse_key(StreamType &stream, std::string_view &key) {
   if (stream->type == Token::Type::String) {
-    key = std::string(stream->value, stream->length);
+    key = std::string_view(stream->value, stream->length);
     if ((++stream)->type == Token::Type::Colon) {
       ++stream;
     }
+    return {};
   } else {
-    throw std::runtime_error("Expected String, got " + token_type_to_string(stream->type) + "!");
+    return parse_error(stream, ParseErrorCode::ExpectedString);
   }
 }
 
@@ -535,7 +1448,12 @@ template <std::output_iterator<char> OutputIterator, is_container Container>
 inline constexpr void ContainerSerializer::serialize(Container const &container, OutputIterator &output) {
   if constexpr (std::is_same<typename Container::value_type, char>::value) {
     *output++ = '"';
-    output = std::copy(std::begin(container), std::end(container), output);
+    if constexpr (ReferencingOutputIterator<OutputIterator> &&
+                  std::contiguous_iterator<decltype(std::begin(container))>) {
+      output.reference(std::to_address(std::begin(container)), std::size(container));
+    } else {
+      output = std::copy(std::begin(container), std::end(container), output);
+    }
     *output++ = '"';
   } else {
     *output++ = '[';
@@ -557,32 +1475,67 @@ template <typename T> template <Span Container> inline constexpr T json<T>::dese
   return res;
 }
 
+template <typename T>
+template <Span Container>
+inline constexpr std::expected<T, ParseError> json<T>::try_deserialize(Container json) {
+  T res;
+  __JSON_PROPAGATE(try_deserialize(json, res));
+  return res;
+}
+
 template <class CharIterator> class Tokenizer {
+  CharIterator begin;
   CharIterator cursor;
   CharIterator end;
+  CharIterator tokenBegin;
   Token currentToken;
 
-  Tokenizer(CharIterator const &begin, CharIterator const &end, Token initialToken)
-      : cursor(begin), end(end), currentToken(initialToken) {}
+  // Consumes the rest of a literal. Returns -1 on a mismatch, otherwise the number of characters cut off by the end of
+  // the input, so that truncated literals are reported as the end of the input instead of being read past it.
+  inline int match_literal(const char *rest) {
+    for (; *rest; ++rest, ++cursor) {
+      if (cursor == end) {
+        return static_cast<int>(std::strlen(rest));
+      }
+      if (*cursor != *rest) {
+        return -1;
+      }
+    }
+    return 0;
+  }
 
 public:
-  Tokenizer(CharIterator const &begin, CharIterator const &end) : cursor(begin), end(end), currentToken() {}
+  Tokenizer(CharIterator const &begin, CharIterator const &end)
+      : begin(begin), cursor(begin), end(end), tokenBegin(begin), currentToken() {}
 
   inline bool operator==(const Tokenizer<CharIterator> &other) const { return cursor == other.cursor; }
   inline Token &operator*() { return currentToken; }
   inline Token *operator->() { return &currentToken; }
-  inline Tokenizer<CharIterator> &operator=(Tokenizer<CharIterator> const &other) {
-    cursor = other.cursor;
-    currentToken = other.currentToken;
-    return *this;
+
+  // Byte offset of the current token from the start of the input
+  inline size_t offset() const { return std::distance(begin, tokenBegin); }
+
+  // Raw access to the input behind the current token for bulk parsers, which seek to where they stopped reading
+  inline const char *raw_cursor() const
+    requires std::contiguous_iterator<CharIterator>
+  {
+    return std::to_address(cursor);
+  }
+  inline const char *raw_end() const
+    requires std::contiguous_iterator<CharIterator>
+  {
+    return std::to_address(end);
+  }
+  inline void seek(const char *position)
+    requires std::contiguous_iterator<CharIterator>
+  {
+    cursor += position - std::to_address(cursor);
   }
 
   inline Tokenizer<CharIterator> operator++(int) {
-    auto it = cursor;
-    auto it_e = cursor;
-    auto tok = currentToken;
+    auto tmp = *this;
     ++*this;
-    return Tokenizer<CharIterator>(it, it_e, tok);
+    return tmp;
   }
 
   inline Tokenizer<CharIterator> &operator++() {
@@ -593,6 +1546,7 @@ public:
     while (cursor != end) {
       switch (state) {
       case TokenizerState::None:
+        tokenBegin = cursor;
         switch (*cursor) {
         case '{':
           currentToken = {Token::Type::LBrace, nullptr, 0};
@@ -691,26 +1645,26 @@ public:
         }
         break; // case TokenizerState::ReadingInteger
       case TokenizerState::ReadingTrue:
-        if (*cursor++ == 'r' && *cursor++ == 'u' && *cursor++ == 'e') {
+        if (int missing = match_literal("rue"); missing == 0) {
           currentToken = {Token::Type::True, nullptr, 0};
           return *this;
-        } else {
+        } else if (missing < 0) {
           REACT_WITH_TOKENIZER_ERROR();
         }
         break; // case TokenizerState::ReadingTrue
       case TokenizerState::ReadingFalse:
-        if (*cursor++ == 'a' && *cursor++ == 'l' && *cursor++ == 's' && *cursor++ == 'e') {
+        if (int missing = match_literal("alse"); missing == 0) {
           currentToken = {Token::Type::False, nullptr, 0};
           return *this;
-        } else {
+        } else if (missing < 0) {
           REACT_WITH_TOKENIZER_ERROR();
         }
         break; // case TokenizerState::ReadingFalse
       case TokenizerState::ReadingNull:
-        if (*cursor++ == 'u' && *cursor++ == 'l' && *cursor++ == 'l') {
+        if (int missing = match_literal("ull"); missing == 0) {
           currentToken = {Token::Type::Null, nullptr, 0};
           return *this;
-        } else {
+        } else if (missing < 0) {
           REACT_WITH_TOKENIZER_ERROR();
         }
         break; // case TokenizerState::ReadingNull
@@ -719,12 +1673,56 @@ public:
         break;
       }
     }
+    tokenBegin = cursor;
     currentToken = {Token::Type::End, nullptr, 0};
     return *this;
   }
 };
 
-template <typename T> template <Span Container> inline constexpr void json<T>::deserialize(Container json, T &output) {
+template <typename T>
+template <Span Container>
+inline constexpr ParseResult json<T>::try_deserialize(Container json, T &output) {
+  auto tok = Tokenizer(std::begin(json), std::end(json));
+  return parse_field(++tok, output);
+}
+
+// Unlike deserialization, validation also rejects trailing tokens after the root value
+template <typename T> template <Span Container> inline constexpr ParseResult json<T>::validate(Container const &json) {
   auto tok = Tokenizer(std::begin(json), std::end(json));
-  parse_tokenstream(++tok, output);
+  __JSON_PROPAGATE(validate_field<T>(++tok));
+  return expect_end(tok);
+}
+
+template <typename T>
+template <Span Container>
+inline constexpr ParseResult json<T>::try_deserialize_reusing(Container const &json, T &output) {
+  auto tok = Tokenizer(std::begin(json), std::end(json));
+  return parse_field<ParseMode::Reuse>(++tok, output);
+}
+
+template <typename T>
+template <Span Container>
+inline constexpr void json<T>::deserialize_reusing(Container const &json, T &output) {
+  if (auto result = try_deserialize_reusing(json, output); !result) {
+    throw ParseException(result.error());
+  }
+}
+
+// A merge patch only contains the members that changed, so applying it means parsing it into the existing object
+template <typename T>
+template <Span Container>
+inline constexpr void json<T>::apply_patch(Container const &patch, T &output) {
+  deserialize_reusing(patch, output);
+}
+
+template <typename T>
+template <Span Container>
+inline constexpr ParseResult json<T>::try_apply_patch(Container const &patch, T &output) {
+  return try_deserialize_reusing(patch, output);
+}
+
+template <typename T> template <Span Container> inline constexpr void json<T>::deserialize(Container json, T &output) {
+  if (auto result = try_deserialize(json, output); !result) {
+    throw ParseException(result.error());
+  }
 }
\ No newline at end of file
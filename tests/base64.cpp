@@ -0,0 +1,142 @@
+// Round-trips byte containers of every length through BASE64(...) fields and checks padding and alphabet errors against
+// a plain reference implementation. Built once as is and once with SSSE3, so that both code paths are covered.
+#include "json-base64.h"
+
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(JSON_TEST_SSSE3) && !defined(__JSON_BASE64_SSSE3)
+#error "The SSSE3 variant of the base64 test was built without SSSE3"
+#endif
+
+struct Attachment {
+  int id;
+  std::vector<uint8_t> data;
+};
+
+JSON(Attachment, FIELDS(id, BASE64(data)))
+
+static int failures = 0;
+
+static void fail(std::string const &test, std::string const &message) {
+  if (failures++ < 20) {
+    std::cerr << test << ": " << message << std::endl;
+  }
+}
+
+static std::string describe(ParseResult const &result) {
+  if (result) {
+    return "success";
+  }
+  return parse_error_code_to_string(result.error().code) + " at offset " + std::to_string(result.error().offset);
+}
+
+// Encodes one sextet at a time, independently of the block-wise implementation
+static std::string reference_encode(std::vector<uint8_t> const &data) {
+  std::string encoded;
+  for (size_t bit = 0; bit < data.size() * 8; bit += 6) {
+    unsigned sextet = 0;
+    for (size_t b = bit; b < bit + 6; b++) {
+      sextet = sextet << 1 | (b < data.size() * 8 ? data[b / 8] >> (7 - b % 8) & 1 : 0);
+    }
+    encoded += BASE64_ALPHABET[sextet];
+  }
+  while (encoded.size() % 4 != 0) {
+    encoded += '=';
+  }
+  return encoded;
+}
+
+static std::string document(std::string const &base64) { return R"({"id": 7, "data": ")" + base64 + R"("})"; }
+
+static void check_round_trip(std::vector<uint8_t> const &data) {
+  std::string test = "length " + std::to_string(data.size());
+  std::string expected = reference_encode(data);
+
+  Attachment attachment{7, data};
+  std::string serialized;
+  auto it = std::back_inserter(serialized);
+  json<Attachment>::serialize(attachment, it);
+  if (serialized != R"({"id": 7,"data": ")" + expected + R"("})") {
+    fail(test, "expected " + expected + ", got " + serialized);
+  }
+
+  // Padding is optional when parsing
+  std::string unpadded = expected.substr(0, expected.find('='));
+  for (std::string const &base64 : {expected, unpadded}) {
+    Attachment parsed;
+    auto result = json<Attachment>::try_deserialize(document(base64), parsed);
+    if (!result) {
+      fail(test, "parsing " + base64 + " failed with " + describe(result));
+    } else if (parsed.data != data) {
+      fail(test, "parsing " + base64 + " gave different bytes");
+    }
+    if (auto valid = json<Attachment>::validate(document(base64)); !valid) {
+      fail(test, "validating " + base64 + " failed with " + describe(valid));
+    }
+  }
+}
+
+// Parsing and validation report invalid base64 at the string
+static void check_invalid(std::string const &base64) {
+  std::string input = document(base64);
+  size_t offset = input.find("\"", input.find("data") + 6);
+  std::string expected = describe(std::unexpected(ParseError{ParseErrorCode::InvalidBase64, offset}));
+  Attachment parsed;
+  if (auto result = json<Attachment>::try_deserialize(input, parsed); describe(result) != expected) {
+    fail("parse " + base64, "expected " + expected + ", got " + describe(result));
+  }
+  if (auto result = json<Attachment>::validate(input); describe(result) != expected) {
+    fail("validate " + base64, "expected " + expected + ", got " + describe(result));
+  }
+}
+
+int main() {
+  std::mt19937 random(1);
+  // Every length modulo 3, well beyond the 12 bytes (16 characters) that a SIMD block covers
+  for (size_t length = 0; length <= 200; length++) {
+    std::vector<uint8_t> data(length);
+    for (auto &byte : data) {
+      byte = static_cast<uint8_t>(random());
+    }
+    check_round_trip(data);
+  }
+  std::vector<uint8_t> allBytes(256);
+  for (size_t i = 0; i < allBytes.size(); i++) {
+    allBytes[i] = static_cast<uint8_t>(i);
+  }
+  check_round_trip(allBytes);
+  check_round_trip(std::vector<uint8_t>(100, 0xFF));
+
+  // Misplaced, excess or partial padding
+  for (auto const &base64 : {"=", "==", "====", "Q===", "QQ=A", "Q=Q=", "QQ=", "QQQ==", "QQ==QUJD", "QUJD=", "=QUJ"}) {
+    check_invalid(base64);
+  }
+  // A length that leaves a single character in the last quad cannot encode a whole byte
+  check_invalid("Q");
+  check_invalid("QUJDQ");
+  check_invalid(std::string(33, 'A'));
+
+  // Characters outside the alphabet, including URL-safe base64 and whitespace, at every position of inputs long enough
+  // to be decoded both block-wise and character by character
+  std::string valid = reference_encode(std::vector<uint8_t>(30, 0x5A));
+  for (char invalid : {'-', '_', ' ', '\n', '.', '\\', '\x7F', '\x80', '\xFF', '{'}) {
+    for (size_t position = 0; position < valid.size(); position++) {
+      std::string base64 = valid;
+      base64[position] = invalid;
+      check_invalid(base64);
+    }
+  }
+
+  if (failures == 0) {
+#ifdef __JSON_BASE64_SSSE3
+    std::cout << "All base64 tests passed (SSSE3)" << std::endl;
+#else
+    std::cout << "All base64 tests passed" << std::endl;
+#endif
+  }
+  return failures == 0 ? 0 : 1;
+}
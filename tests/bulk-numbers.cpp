@@ -0,0 +1,165 @@
+// Parses numeric arrays from contiguous input, which goes through the bulk number parser, and from a std::deque, which
+// goes through the tokenizer, and checks that results and error offsets agree.
+#include "json-parsing.h"
+
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+template <typename T> static std::string describe(ParseResult const &result, std::vector<T> const &values) {
+  if (!result) {
+    return parse_error_code_to_string(result.error().code) + " at offset " + std::to_string(result.error().offset);
+  }
+  std::string description = "[";
+  for (T value : values) {
+    description += std::to_string(value) + ",";
+  }
+  return description + "]";
+}
+
+template <typename T> static void check_input(std::string const &input) {
+  std::vector<T> bulk;
+  auto bulkResult = json<std::vector<T>>::try_deserialize(input, bulk);
+  std::vector<T> tokenized;
+  auto tokenizedResult = json<std::vector<T>>::try_deserialize(std::deque<char>(input.begin(), input.end()), tokenized);
+
+  std::string expected = describe(tokenizedResult, tokenized);
+  std::string actual = describe(bulkResult, bulk);
+  // Comparing bit patterns also catches differences in rounding that to_string does not show. The contents of the
+  // vectors after an error are unspecified.
+  bool equal = expected == actual;
+  if (equal && bulkResult) {
+    equal = std::equal(bulk.begin(), bulk.end(), tokenized.begin(), tokenized.end(),
+                       [](T a, T b) { return std::memcmp(&a, &b, sizeof(T)) == 0; });
+  }
+  if (!equal && failures++ < 20) {
+    std::cerr << typeid(T).name() << " " << input << ": expected " << expected << ", got " << actual << std::endl;
+  }
+}
+
+static void check_all_types(std::string const &input) {
+  check_input<int>(input);
+  check_input<unsigned int>(input);
+  check_input<int64_t>(input);
+  check_input<uint64_t>(input);
+  check_input<short>(input);
+  check_input<unsigned char>(input);
+  check_input<float>(input);
+  check_input<double>(input);
+}
+
+// Boundaries of the integer types, forms that only one of the parsers might accept and values that are hard to round
+static const char *const ELEMENTS[] = {"0",
+                                       "7",
+                                       "-7",
+                                       "-0",
+                                       "007",
+                                       "255",
+                                       "256",
+                                       "65535",
+                                       "65536",
+                                       "1234567",
+                                       "12345678",
+                                       "-1234567",
+                                       "2147483647",
+                                       "2147483648",
+                                       "-2147483648",
+                                       "4294967296",
+                                       "9223372036854775807",
+                                       "18446744073709551615",
+                                       "99999999999999999999",
+                                       "1.5",
+                                       "-1.5",
+                                       "0.1",
+                                       "0.30000000000000004",
+                                       "1.00000005960464477539",
+                                       "16777217",
+                                       "340282356779733661637539395458142568448",
+                                       "1.",
+                                       "-.5",
+                                       ".5",
+                                       "-",
+                                       "--1",
+                                       "+1",
+                                       "1-2",
+                                       "1.2.3",
+                                       "1e5",
+                                       "1E5",
+                                       "0x10",
+                                       "nan",
+                                       "-nan",
+                                       "inf",
+                                       "-inf",
+                                       "infinity",
+                                       "true",
+                                       "null",
+                                       "\"1\"",
+                                       "[1]",
+                                       "{}"};
+
+static std::string random_array(std::mt19937 &random) {
+  std::uniform_int_distribution<size_t> element(0, std::size(ELEMENTS) - 1);
+  std::uniform_int_distribution<int> count(0, 12);
+  std::uniform_int_distribution<int> digits(1, 20);
+  std::uniform_int_distribution<int> percent(0, 99);
+  static const char *const SPACES[] = {"", " ", "\n", "\t ", "  "};
+  std::uniform_int_distribution<size_t> space(0, std::size(SPACES) - 1);
+
+  std::string input = "[" + std::string(SPACES[space(random)]);
+  for (int i = count(random); i > 0; i--) {
+    if (percent(random) < 50) {
+      // Random numbers of any length, most of which are valid
+      if (percent(random) < 30) {
+        input += '-';
+      }
+      for (int n = digits(random); n > 0; n--) {
+        input += static_cast<char>('0' + random() % 10);
+      }
+      if (percent(random) < 30) {
+        input += '.';
+        for (int n = digits(random); n > 0; n--) {
+          input += static_cast<char>('0' + random() % 10);
+        }
+      }
+    } else {
+      input += ELEMENTS[element(random)];
+    }
+    input += SPACES[space(random)];
+    int separator = percent(random);
+    if (i > 1 || separator < 3) {
+      input += separator < 97 ? "," : separator < 99 ? "" : ";";
+    }
+    input += SPACES[space(random)];
+  }
+  if (percent(random) < 95) {
+    input += "]";
+  }
+  return input;
+}
+
+int main() {
+  for (const char *element : ELEMENTS) {
+    check_all_types(std::string("[") + element + "]");
+    check_all_types(std::string("[1, ") + element + ", 2]");
+    check_all_types(std::string("[") + element + ",");
+  }
+  check_all_types("[]");
+  check_all_types("[ ]");
+  check_all_types("[1, 2,]");
+  check_all_types("[1 2]");
+  check_all_types("[1, 2");
+
+  std::mt19937 random(1);
+  for (int i = 0; i < 20000; i++) {
+    check_all_types(random_array(random));
+  }
+
+  if (failures == 0) {
+    std::cout << "All bulk number tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+// Parses the same documents from memory and from plain, gzip and zstd files and checks that results and error offsets
+// agree. Built with a small COMPRESSED_INPUT_BUFFER_SIZE, so that tokens cross many buffer boundaries.
+#ifdef JSON_TEST_ZSTD
+#include <zstd.h>
+#endif
+
+#include "json-compressed.h"
+
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Comment {
+  std::string author;
+  std::string content;
+  uint64_t timestamp;
+
+  bool operator==(Comment const &other) const = default;
+};
+
+JSON(Comment, FIELDS(author, content, timestamp))
+
+enum class Format { Plain, Gzip, Zstd };
+
+static int failures = 0;
+
+static void fail(std::string const &test, std::string const &message) {
+  std::cerr << test << ": " << message << std::endl;
+  failures++;
+}
+
+static std::string describe(ParseResult const &result) {
+  if (result) {
+    return "success";
+  }
+  return parse_error_code_to_string(result.error().code) + " at offset " + std::to_string(result.error().offset);
+}
+
+static void write_file(std::string const &path, std::string const &data, Format format) {
+  if (format == Format::Gzip) {
+    gzFile file = gzopen(path.c_str(), "wb");
+    gzwrite(file, data.data(), static_cast<unsigned>(data.size()));
+    gzclose(file);
+    return;
+  }
+  std::string bytes = data;
+#ifdef JSON_TEST_ZSTD
+  if (format == Format::Zstd) {
+    bytes.resize(ZSTD_compressBound(data.size()));
+    bytes.resize(ZSTD_compress(bytes.data(), bytes.size(), data.data(), data.size(), 3));
+  }
+#endif
+  FILE *file = std::fopen(path.c_str(), "wb");
+  std::fwrite(bytes.data(), 1, bytes.size(), file);
+  std::fclose(file);
+}
+
+static std::string read_file(std::string const &path) {
+  std::string data;
+  FILE *file = std::fopen(path.c_str(), "rb");
+  char chunk[4096];
+  for (size_t length; (length = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) {
+    data.append(chunk, length);
+  }
+  std::fclose(file);
+  return data;
+}
+
+static std::vector<Format> formats() {
+#ifdef JSON_TEST_ZSTD
+  return {Format::Plain, Format::Gzip, Format::Zstd};
+#else
+  return {Format::Plain, Format::Gzip};
+#endif
+}
+
+static std::string format_name(Format format) {
+  switch (format) {
+  case Format::Plain:
+    return "plain";
+  case Format::Gzip:
+    return "gzip";
+  default:
+    return "zstd";
+  }
+}
+
+template <typename T> static void check_document(std::string const &test, std::string const &document) {
+  T expected;
+  auto expectedResult = json<T>::try_deserialize(std::string_view(document), expected);
+  for (Format format : formats()) {
+    std::string path = "compressed-input-test." + format_name(format);
+    write_file(path, document, format);
+    T actual;
+    auto actualResult = compressed_json<T>::try_deserialize(path, actual);
+    std::remove(path.c_str());
+
+    std::string name = test + " (" + format_name(format) + ")";
+    if (describe(actualResult) != describe(expectedResult)) {
+      fail(name, "expected " + describe(expectedResult) + ", got " + describe(actualResult));
+    } else if (actualResult && !(actual == expected)) {
+      fail(name, "parsed value differs");
+    }
+  }
+}
+
+// Compressed files that are cut off are reported as corrupt, not as the end of the input
+static void check_truncated_file(std::string const &document, Format format) {
+  std::string path = "compressed-input-test." + format_name(format);
+  write_file(path, document, format);
+  std::string bytes = read_file(path);
+  write_file(path, bytes.substr(0, bytes.size() / 2), Format::Plain);
+  auto result = compressed_json<std::vector<Comment>>::try_deserialize(path);
+  std::remove(path.c_str());
+  if (result || result.error().code != ParseErrorCode::DecompressionFailed) {
+    fail("truncated " + format_name(format) + " file", "expected DecompressionFailed");
+  }
+}
+
+static std::string comments(size_t count, size_t contentLength) {
+  std::string document = "[";
+  for (size_t i = 0; i < count; i++) {
+    document += i > 0 ? ", " : "";
+    document += R"({"author":"u","content":")" + std::string(contentLength, 'a' + i % 26) + R"(","timestamp":5})";
+  }
+  return document + "]";
+}
+
+static std::string random_strings(size_t count, size_t minLength, size_t maxLength, unsigned seed) {
+  std::mt19937 random(seed);
+  std::uniform_int_distribution<size_t> length(minLength, maxLength);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::string document = "[";
+  for (size_t i = 0; i < count; i++) {
+    document += i > 0 ? ",\n\"" : "\"";
+    for (size_t n = length(random); n > 0; n--) {
+      document += static_cast<char>(letter(random));
+    }
+    document += '"';
+  }
+  return document + "]";
+}
+
+int main() {
+  check_document<std::vector<Comment>>("empty array", "[]");
+  check_document<std::vector<Comment>>("short strings", comments(3, 3));
+  check_document<std::vector<Comment>>("strings longer than a buffer", comments(3, 100));
+  check_document<std::vector<Comment>>("strings longer than the carry space", comments(50, 5000));
+  check_document<std::vector<std::string>>("many long strings", random_strings(2000, 1100, 4000, 2));
+  check_document<std::vector<bool>>("literals", "[true, false, true, false, true, false, true, false, true]");
+  check_document<std::vector<int64_t>>("numbers", "[1, -22, 333, -4444, 55555, -666666, 7777777, -88888888]");
+
+  std::string document = comments(20, 50);
+  check_document<std::vector<Comment>>("cut off in a string", document.substr(0, document.size() / 2));
+  check_document<std::vector<Comment>>("cut off after a key", document.substr(0, document.find("content") + 8));
+  check_document<std::vector<bool>>("cut off in a literal", "[true, false, tr");
+  check_document<std::vector<bool>>("misspelled literal", "[true, fasle]");
+  check_document<std::vector<Comment>>("invalid token", document.substr(0, 300) + "#" + document.substr(300));
+  check_document<std::vector<Comment>>("unexpected type", R"([{"author":"u","content":5,"timestamp":5}])");
+
+  if (auto result = compressed_json<std::vector<Comment>>::try_deserialize("missing-file.json.gz");
+      result || result.error().code != ParseErrorCode::InputUnavailable) {
+    fail("missing file", "expected InputUnavailable");
+  }
+  check_truncated_file(document, Format::Gzip);
+#ifdef JSON_TEST_ZSTD
+  check_truncated_file(document, Format::Zstd);
+#endif
+
+  if (failures == 0) {
+    std::cout << "All compressed input tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+// Checks that applying the merge patch from json<T>::serialize_diff(a, b) to a copy of a yields b, and that the patch
+// only contains what changed
+#include "json-parsing.h"
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct Shape {
+  virtual ~Shape() = default;
+};
+
+struct Circle : Shape {
+  double radius;
+};
+
+struct Square : Shape {
+  double side;
+  std::string colour;
+};
+
+struct Camera {
+  int depth;
+  double zoom;
+};
+
+struct Settings {
+  std::string name;
+  Camera camera;
+  int priority;
+};
+
+struct Scene {
+  Settings settings;
+  std::vector<int> layers;
+  std::vector<std::string> tags;
+  Shape *shape = nullptr;
+  Shape *overlay = nullptr;
+};
+
+JSON(Circle, FIELDS(radius))
+JSON(Square, FIELDS(side, colour))
+JSON(Shape *, SUBTYPES(Circle, Square))
+JSON(Camera, FIELDS(depth, zoom))
+JSON(Settings, FIELDS(name, camera, priority))
+JSON(Scene, FIELDS(settings, layers, tags, shape, overlay))
+
+static int failures = 0;
+
+static void fail(std::string const &test, std::string const &message) {
+  std::cerr << test << ": " << message << std::endl;
+  failures++;
+}
+
+template <typename T> static std::string serialize(T const &object) {
+  std::string output;
+  auto it = std::back_inserter(output);
+  json<T>::serialize(object, it);
+  return output;
+}
+
+template <typename T> static std::string serialize_diff(T const &old_object, T const &object) {
+  std::string output;
+  auto it = std::back_inserter(output);
+  json<T>::serialize_diff(old_object, object, it);
+  return output;
+}
+
+static Shape *circle(double radius) {
+  auto shape = new Circle();
+  shape->radius = radius;
+  return shape;
+}
+
+static Shape *square(double side, std::string const &colour) {
+  auto shape = new Square();
+  shape->side = side;
+  shape->colour = colour;
+  return shape;
+}
+
+static Scene scene() {
+  Scene scene;
+  scene.settings = {"main", {3, 1.5}, 1};
+  scene.layers = {1, 2, 3};
+  scene.tags = {"a", "b"};
+  scene.shape = circle(2);
+  scene.overlay = square(1, "red");
+  return scene;
+}
+
+// Applies the patch from a to b to a copy of a and compares the result with b. If expectedPatch is given, the patch
+// must match it exactly.
+static void check_round_trip(std::string const &test, Scene const &a, Scene const &b,
+                             std::string const &expectedPatch = "") {
+  std::string patch = serialize_diff(a, b);
+  if (!expectedPatch.empty() && patch != expectedPatch) {
+    fail(test, "expected patch " + expectedPatch + ", got " + patch);
+  }
+
+  Scene patched;
+  json<Scene>::deserialize(serialize(a), patched);
+  if (auto result = json<Scene>::try_apply_patch(patch, patched); !result) {
+    fail(test, "applying " + patch + " failed with " + parse_error_code_to_string(result.error().code));
+    return;
+  }
+  if (!json_equal(patched, b) || serialize(patched) != serialize(b)) {
+    fail(test, "patch " + patch + " produced " + serialize(patched) + ", expected " + serialize(b));
+  }
+}
+
+int main() {
+  Scene a = scene();
+
+  check_round_trip("unchanged", a, scene(), "{}");
+
+  Scene nested = scene();
+  nested.settings.camera.depth = 4;
+  check_round_trip("nested object", a, nested, R"({"settings": {"camera": {"depth": 4}}})");
+
+  Scene siblings = scene();
+  siblings.settings.name = "other";
+  siblings.settings.camera.zoom = 0.25;
+  siblings.settings.priority = 2;
+  check_round_trip("several nested members", a, siblings);
+
+  // Arrays are replaced wholesale, whether they shrink, grow or only change an element
+  Scene shrunk = scene();
+  shrunk.layers = {1};
+  shrunk.tags.clear();
+  check_round_trip("shrunk arrays", a, shrunk, R"({"layers": [1],"tags": []})");
+
+  Scene grown = scene();
+  grown.layers = {1, 2, 3, 4, 5};
+  grown.tags.push_back("c");
+  check_round_trip("grown arrays", a, grown);
+
+  Scene changedElement = scene();
+  changedElement.layers[1] = 7;
+  check_round_trip("changed array element", a, changedElement, R"({"layers": [1,7,3]})");
+
+  // Null removes a member, and a removed member can be added again
+  Scene removed = scene();
+  removed.overlay = nullptr;
+  check_round_trip("null removal", a, removed, R"({"overlay": null})");
+  check_round_trip("re-adding a removed member", removed, a, R"({"overlay": {"Square": {"side": 1,"colour": "red"}}})");
+
+  Scene allRemoved = scene();
+  allRemoved.shape = nullptr;
+  allRemoved.overlay = nullptr;
+  check_round_trip("removing all pointers", a, allRemoved);
+  check_round_trip("both null", allRemoved, allRemoved, "{}");
+  if (auto result = json<Scene>::validate(serialize(allRemoved)); !result) {
+    fail("validating null members", parse_error_code_to_string(result.error().code));
+  }
+
+  // Polymorphic members are diffed if their type stays the same and replaced otherwise
+  Scene resized = scene();
+  static_cast<Circle *>(resized.shape)->radius = 5;
+  check_round_trip("changed subtype member", a, resized, R"({"shape": {"Circle": {"radius": 5}}})");
+
+  Scene replaced = scene();
+  replaced.shape = square(2, "blue");
+  check_round_trip("changed subtype", a, replaced, R"({"shape": {"Square": {"side": 2,"colour": "blue"}}})");
+
+  Scene everything = scene();
+  everything.settings = {"new", {9, 3}, 0};
+  everything.layers = {};
+  everything.tags = {"x", "y", "z"};
+  everything.shape = nullptr;
+  everything.overlay = circle(1);
+  check_round_trip("everything changed", a, everything);
+  check_round_trip("everything changed back", everything, a);
+
+  if (failures == 0) {
+    std::cout << "All diff and patch tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+// Checks the error codes and offsets that parsing and validation report for malformed input
+#include "json-parsing.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Point {
+  int x;
+  int y;
+};
+
+JSON(Point, FIELDS(x, y))
+
+static int failures = 0;
+
+static std::string describe(ParseResult const &result) {
+  if (result) {
+    return "success";
+  }
+  return parse_error_code_to_string(result.error().code) + " at offset " + std::to_string(result.error().offset);
+}
+
+static void check(std::string const &test, ParseResult const &result, ParseErrorCode code, size_t offset) {
+  std::string expected = describe(std::unexpected(ParseError{code, offset}));
+  if (describe(result) != expected) {
+    std::cerr << test << ": expected " << expected << ", got " << describe(result) << std::endl;
+    failures++;
+  }
+}
+
+// Parsing and validation report the same error
+template <typename T> static void check_input(std::string const &input, ParseErrorCode code, size_t offset) {
+  T output;
+  check("parse " + input, json<T>::try_deserialize(input, output), code, offset);
+  check("validate " + input, json<T>::validate(input), code, offset);
+}
+
+template <typename T> static void check_validation(std::string const &input, ParseErrorCode code, size_t offset) {
+  check("validate " + input, json<T>::validate(input), code, offset);
+}
+
+int main() {
+  // Unknown keys are reported at the key, not at the value following it
+  check_input<Point>(R"({"x": 1, "bogus": 12345})", ParseErrorCode::UnexpectedKey, 9);
+  check_input<Point>(R"({"bogus": {"x": 1}})", ParseErrorCode::UnexpectedKey, 1);
+  check_input<Point>(R"({"x": 1, "y": "2"})", ParseErrorCode::ExpectedInteger, 14);
+  check_input<Point>(R"({"x": 1 "y": 2})", ParseErrorCode::ExpectedObjectEnd, 8);
+  check_input<Point>(R"([1, 2])", ParseErrorCode::ExpectedObject, 0);
+  check_input<Point>(R"({"x": 1, "y": 2)", ParseErrorCode::UnexpectedEnd, 15);
+
+  // Malformed numbers are reported as the expected type, numbers that do not fit as out of range
+  check_validation<std::vector<int>>("[1, -]", ParseErrorCode::ExpectedInteger, 4);
+  check_validation<std::vector<double>>("[1.5, -]", ParseErrorCode::ExpectedNumber, 6);
+  check_validation<std::vector<double>>("[1.5, -.]", ParseErrorCode::ExpectedNumber, 6);
+  check_validation<std::vector<int>>("[1, 1e]", ParseErrorCode::InvalidToken, 4);
+  check_validation<std::vector<uint8_t>>("[255, 256]", ParseErrorCode::NumberOutOfRange, 6);
+  check_validation<std::vector<unsigned>>("[1, -1]", ParseErrorCode::NumberOutOfRange, 4);
+  check_validation<std::vector<uint64_t>>("[1, -99999999999999999999]", ParseErrorCode::NumberOutOfRange, 4);
+  check_validation<std::vector<int64_t>>("[99999999999999999999]", ParseErrorCode::NumberOutOfRange, 1);
+  for (auto const &valid : {"[-0, 0, 007]", "[1., -.5, 2.25]"}) {
+    if (auto result = json<std::vector<double>>::validate(std::string(valid)); !result) {
+      std::cerr << "validate " << valid << ": expected success, got " << describe(result) << std::endl;
+      failures++;
+    }
+  }
+  if (auto result = json<std::vector<unsigned>>::validate(std::string("[-0]")); !result) {
+    std::cerr << "validate [-0]: expected success, got " << describe(result) << std::endl;
+    failures++;
+  }
+
+  if (failures == 0) {
+    std::cout << "All error tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
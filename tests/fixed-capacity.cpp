@@ -0,0 +1,148 @@
+// Checks that fixed capacity containers accept exactly as many elements or characters as they hold and report the
+// first one that does not fit as CapacityExceeded, and that parsing them from a string_view does not allocate
+#include <array>
+
+#include "json-fixed-capacity.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+
+static size_t allocations = 0;
+
+void *operator new(size_t size) {
+  allocations++;
+  if (void *memory = std::malloc(size > 0 ? size : 1)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+struct Point {
+  int x;
+  double y;
+};
+
+struct Order {
+  FixedString<16> symbol;
+  FixedVector<Point, 4> points;
+  FixedVector<int, 8> ids;
+  std::array<int, 3> triple;
+  std::array<char, 4> code;
+  int quantity;
+};
+
+struct Empty {
+  FixedVector<int, 0> none;
+};
+
+JSON(Point, FIELDS(x, y))
+JSON(Order, FIELDS(symbol, points, ids, triple, code, quantity))
+JSON(Empty, FIELDS(none))
+
+static int failures = 0;
+
+static std::string describe(ParseResult const &result) {
+  if (result) {
+    return "success";
+  }
+  return parse_error_code_to_string(result.error().code) + " at offset " + std::to_string(result.error().offset);
+}
+
+static void check(std::string const &test, ParseResult const &result, std::string const &expected) {
+  if (describe(result) != expected) {
+    std::cerr << test << ": expected " << expected << ", got " << describe(result) << std::endl;
+    failures++;
+  }
+}
+
+// Parsing and validation report the same result
+template <typename T> static void check_input(std::string const &input, std::string const &expected) {
+  T output;
+  check("parse " + input, json<T>::try_deserialize(std::string_view(input), output), expected);
+  check("validate " + input, json<T>::validate(std::string_view(input)), expected);
+}
+
+static std::string capacity_exceeded(size_t offset) {
+  return describe(std::unexpected(ParseError{ParseErrorCode::CapacityExceeded, offset}));
+}
+
+// An array of capacity elements fits, one more is reported at the element that does not fit
+template <typename T> static void check_array_capacity(std::string const &key, std::string const &element, size_t n) {
+  std::string input = "{\"" + key + "\": [";
+  for (size_t i = 0; i < n; i++) {
+    input += element + ", ";
+  }
+  check_input<T>(input.substr(0, input.size() - (n > 0 ? 2 : 0)) + "]}", "success");
+  size_t offset = input.size();
+  check_input<T>(input + element + "]}", capacity_exceeded(offset));
+  check_input<T>(input + element + ", " + element + "]}", capacity_exceeded(offset));
+}
+
+// A string of capacity characters fits, one more is reported at the string
+template <typename T> static void check_string_capacity(std::string const &key, size_t n) {
+  std::string input = "{\"" + key + "\": ";
+  check_input<T>(input + "\"" + std::string(n, 'a') + "\"}", "success");
+  check_input<T>(input + "\"" + std::string(n + 1, 'a') + "\"}", capacity_exceeded(input.size()));
+}
+
+int main() {
+  check_array_capacity<Order>("points", R"({"x": 1, "y": 2.5})", 4);
+  check_array_capacity<Order>("ids", "7", 8);
+  check_array_capacity<Order>("triple", "-3", 3);
+  check_string_capacity<Order>("symbol", 16);
+  check_string_capacity<Order>("code", 4);
+  check_array_capacity<Empty>("none", "1", 0);
+
+  // Arrays without an enclosing object, and elements appended behind existing ones in construct mode
+  check("root array", json<FixedVector<int, 2>>::validate(std::string_view("[1, 2, 3]")), capacity_exceeded(7));
+  FixedVector<int, 4> appended{1, 2};
+  check("appending", json<FixedVector<int, 4>>::try_deserialize(std::string_view("[3, 4]"), appended), "success");
+  if (appended != FixedVector<int, 4>{1, 2, 3, 4}) {
+    std::cerr << "appending: wrong elements" << std::endl;
+    failures++;
+  }
+  check("appending beyond capacity",
+        json<FixedVector<int, 4>>::try_deserialize(std::string_view("[5]"), appended), capacity_exceeded(1));
+
+  // Nothing is allocated while parsing, reusing or validating. Results are only checked afterwards, since describing
+  // them allocates.
+  std::string_view first =
+      R"({"symbol": "ABCDEFGHIJKLMNOP", "points": [{"x": 1, "y": 2.5}, {"x": 3, "y": 4}, {"x": 5, "y": 6},)"
+      R"( {"x": 7, "y": 8}], "ids": [1, 2, 3, 4, 5, 6, 7, 8], "triple": [7, 8, 9], "code": "WXYZ", "quantity": 5})";
+  std::string_view second = R"({"symbol": "A", "points": [{"x": 9, "y": 1}], "ids": [], "code": "Q"})";
+  size_t before = allocations;
+  Order order;
+  ParseResult results[] = {json<Order>::try_deserialize(first, order),
+                           json<Order>::try_deserialize_reusing(second, order),
+                           json<Order>::try_deserialize_reusing(first, order), json<Order>::validate(first)};
+  if (size_t count = allocations - before; count > 0) {
+    std::cerr << "parsing, reusing and validating: " << count << " allocations" << std::endl;
+    failures++;
+  }
+  for (auto const &result : results) {
+    check("parsing, reusing and validating", result, "success");
+  }
+  if (order.symbol != "ABCDEFGHIJKLMNOP" || order.points.size() != 4 || order.points[3].x != 7 ||
+      order.ids.size() != 8 || order.triple[2] != 9 || std::string_view(order.code.data(), 4) != "WXYZ") {
+    std::cerr << "reusing: wrong values" << std::endl;
+    failures++;
+  }
+
+  // Reuse overwrites from the front and drops surplus elements, arrays keep the elements missing from the input
+  check("shrinking", json<Order>::try_deserialize_reusing(second, order), "success");
+  if (order.symbol != "A" || order.points.size() != 1 || order.points[0].x != 9 || !order.ids.empty() ||
+      order.triple[0] != 7 || order.code[0] != 'Q' || order.code[1] != 0) {
+    std::cerr << "shrinking: wrong values" << std::endl;
+    failures++;
+  }
+
+  if (failures == 0) {
+    std::cout << "All fixed capacity tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+// Serializes into an IovecSink, writes it to a pipe and to a file with writev and checks that the bytes match those of
+// the copying serializer. Many long strings make for more than IOV_MAX segments, and a timer signal interrupting the
+// writes to a slowly drained pipe makes writev return early, both with partial writes and with EINTR.
+#include "json-iovec.h"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <iterator>
+#include <pthread.h>
+#include <string>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+struct Post {
+  std::string title;
+  std::string body;
+  std::vector<char> raw;
+  int likes;
+};
+
+JSON(Post, FIELDS(title, body, raw, likes))
+
+static int failures = 0;
+
+static void fail(std::string const &test, std::string const &message) {
+  std::cerr << test << ": " << message << std::endl;
+  failures++;
+}
+
+static std::vector<Post> posts(size_t count, size_t bodyLength) {
+  std::vector<Post> posts;
+  for (size_t i = 0; i < count; i++) {
+    std::string body(bodyLength + i % 7, static_cast<char>('a' + i % 26));
+    posts.push_back({"post " + std::to_string(i), body, std::vector<char>(i % 300, 'r'), static_cast<int>(i)});
+  }
+  return posts;
+}
+
+static std::string serialize(std::vector<Post> const &posts) {
+  std::string output;
+  auto it = std::back_inserter(output);
+  serialize_field(posts, it);
+  return output;
+}
+
+static std::string gather(IovecSink const &sink) {
+  std::string gathered;
+  for (iovec const &vector : sink.iovecs()) {
+    gathered.append(static_cast<const char *>(vector.iov_base), vector.iov_len);
+  }
+  return gathered;
+}
+
+// Strings of at least IOVEC_REFERENCE_MIN_SIZE characters are referenced where they are stored, shorter ones copied
+static void check_references(std::string const &test, IovecSink const &sink, std::vector<Post> const &posts) {
+  std::vector<iovec> vectors = sink.iovecs();
+  auto referenced = [&](const char *data) {
+    return std::any_of(vectors.begin(), vectors.end(), [&](iovec const &vector) { return vector.iov_base == data; });
+  };
+  for (Post const &post : posts) {
+    if (referenced(post.title.data())) {
+      fail(test, "short title was referenced");
+    }
+    if (referenced(post.body.data()) != (post.body.size() >= IOVEC_REFERENCE_MIN_SIZE)) {
+      fail(test, "body of " + std::to_string(post.body.size()) + " characters was referenced incorrectly");
+    }
+    if (!post.raw.empty() && referenced(post.raw.data()) != (post.raw.size() >= IOVEC_REFERENCE_MIN_SIZE)) {
+      fail(test, "raw data of " + std::to_string(post.raw.size()) + " characters was referenced incorrectly");
+    }
+  }
+}
+
+static void interrupt(int) {}
+
+static void set_timer(suseconds_t interval) {
+  itimerval timer = {{0, interval}, {0, interval}};
+  setitimer(ITIMER_REAL, &timer, nullptr);
+}
+
+// Reads the pipe on another thread while the sink is written to it, since the pipe only holds a page. The reader is
+// slow, so that the writer blocks and the timer interrupts it.
+static std::string write_through_pipe(IovecSink const &sink, bool &written) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return "";
+  }
+  fcntl(fds[1], F_SETPIPE_SZ, 4096);
+  std::string received;
+  std::thread reader([&]() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    char chunk[1000];
+    for (ssize_t length; (length = read(fds[0], chunk, sizeof(chunk))) > 0;) {
+      received.append(chunk, length);
+      usleep(20);
+    }
+  });
+
+  // Without SA_RESTART, so that the signal interrupts writev instead of restarting it
+  struct sigaction action = {};
+  action.sa_handler = interrupt;
+  sigaction(SIGALRM, &action, nullptr);
+  set_timer(100);
+  written = sink.write_to(fds[1]);
+  set_timer(0);
+
+  close(fds[1]);
+  reader.join();
+  close(fds[0]);
+  return received;
+}
+
+static std::string write_through_file(IovecSink const &sink, bool &written) {
+  FILE *file = std::tmpfile();
+  written = sink.write_to(fileno(file));
+  std::fflush(file);
+  std::rewind(file);
+  std::string received;
+  char chunk[4096];
+  for (size_t length; (length = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) {
+    received.append(chunk, length);
+  }
+  std::fclose(file);
+  return received;
+}
+
+static void check_document(std::string const &test, std::vector<Post> const &posts, IovecSink &sink) {
+  std::string expected = serialize(posts);
+  sink.clear();
+  auto output = sink.output();
+  serialize_field(posts, output);
+
+  if (sink.size() != expected.size()) {
+    fail(test, "sink holds " + std::to_string(sink.size()) + " bytes instead of " + std::to_string(expected.size()));
+  }
+  if (gather(sink) != expected) {
+    fail(test, "iovecs differ from the copying serializer");
+  }
+  check_references(test, sink, posts);
+
+  bool written;
+  if (write_through_pipe(sink, written) != expected || !written) {
+    fail(test, "bytes written to a pipe differ");
+  }
+  if (write_through_file(sink, written) != expected || !written) {
+    fail(test, "bytes written to a file differ");
+  }
+}
+
+int main() {
+  // The sink is reused for all documents, which it has to be emptied for
+  IovecSink sink;
+  check_document("empty", {}, sink);
+  check_document("short strings", posts(10, 10), sink);
+  check_document("around the reference threshold", posts(20, IOVEC_REFERENCE_MIN_SIZE - 3), sink);
+  std::vector<Post> many = posts(3000, 1000);
+  check_document("more segments than IOV_MAX", many, sink);
+  if (sink.iovecs().size() <= IOV_MAX) {
+    fail("more segments than IOV_MAX", "only " + std::to_string(sink.iovecs().size()) + " segments");
+  }
+
+  errno = 0;
+  if (sink.write_to(-1) || errno != EBADF) {
+    fail("invalid file descriptor", "expected failure with EBADF");
+  }
+
+  if (failures == 0) {
+    std::cout << "All iovec tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// Serializes objects through a MemoizingOutput while editing them and checks that the output matches the plain
+// serializer as long as versions are bumped with every change, and that unchanged versions are served from the cache
+#include "json-memoization.h"
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+inline uint64_t next_version() {
+  static uint64_t counter = 0;
+  return ++counter;
+}
+
+struct Image {
+  uint64_t version = next_version();
+  uint8_t format = 0;
+  virtual ~Image() = default;
+};
+
+struct RemoteImage : Image {
+  std::string url;
+  int width;
+  int height;
+};
+
+struct Comment {
+  uint64_t version = next_version();
+  std::string author;
+  std::string content;
+  uint64_t timestamp;
+};
+
+// A container is versioned as a whole, so its version has to change whenever an element changes
+struct CommentList : std::vector<Comment> {
+  uint64_t version = next_version();
+};
+
+struct Post {
+  std::string title;
+  Image *image;
+  std::vector<Comment> comments;
+  CommentList pinned;
+};
+
+JSON(RemoteImage, FIELDS(url, width, height))
+JSON(Image *, SUBTYPES(RemoteImage), POINTER_FIELDS(format))
+JSON(Comment, FIELDS(author, content, timestamp))
+JSON(Post, FIELDS(title, image, comments, pinned))
+
+uint64_t json_version(Image const &image) { return image.version; }
+uint64_t json_version(Comment const &comment) { return comment.version; }
+uint64_t json_version(CommentList const &comments) { return comments.version; }
+
+static int failures = 0;
+
+static void fail(std::string const &test, std::string const &message) {
+  std::cerr << test << ": " << message << std::endl;
+  failures++;
+}
+
+static std::string plain(Post const &post) {
+  std::string output;
+  auto it = std::back_inserter(output);
+  json<Post>::serialize(post, it);
+  return output;
+}
+
+static std::string memoized(SerializationCache &cache, Post const &post) {
+  std::string output;
+  auto it = MemoizingOutput(cache, output);
+  json<Post>::serialize(post, it);
+  return output;
+}
+
+static void check(std::string const &test, SerializationCache &cache, Post const &post) {
+  if (std::string output = memoized(cache, post); output != plain(post)) {
+    fail(test, "expected " + plain(post).substr(0, 200) + "..., got " + output.substr(0, 200) + "...");
+  }
+}
+
+static Comment comment(size_t i) {
+  return Comment{.author = "user" + std::to_string(i % 40),
+                 .content = "This is comment number " + std::to_string(i),
+                 .timestamp = 1234567890ull + i};
+}
+
+int main() {
+  RemoteImage image;
+  image.url = "https://example.com/a.png";
+  image.width = 800;
+  image.height = 600;
+  Post post{"title", &image, {}, {}};
+  for (size_t i = 0; i < 1000; i++) {
+    post.comments.push_back(comment(i));
+  }
+  for (size_t i = 0; i < 10; i++) {
+    post.pinned.push_back(comment(i));
+  }
+
+  SerializationCache cache;
+  check("first serialization", cache, post);
+  // The image, every comment in both lists and the pinned list itself
+  if (cache.size() != 1 + post.comments.size() + post.pinned.size() + 1) {
+    fail("first serialization", "cache holds " + std::to_string(cache.size()) + " entries");
+  }
+  check("unchanged", cache, post);
+
+  post.title = "new title";
+  post.comments[5].content = "edited";
+  post.comments[5].version = next_version();
+  image.width = 1;
+  image.version = next_version();
+  check("edited members", cache, post);
+
+  post.pinned[3].content = "edited";
+  post.pinned[3].version = next_version();
+  post.pinned.version = next_version();
+  check("edited element of a versioned list", cache, post);
+
+  post.comments.erase(post.comments.begin() + 10);
+  post.comments.push_back(comment(5000));
+  post.comments.insert(post.comments.begin(), comment(6000));
+  check("inserted and removed elements", cache, post);
+
+  // Elements are moved to new addresses along with their versions when the vector grows
+  post.comments.shrink_to_fit();
+  post.comments.push_back(comment(7000));
+  check("reallocated elements", cache, post);
+
+  post.image = nullptr;
+  check("removed image", cache, post);
+  post.image = &image;
+  check("restored image", cache, post);
+
+  // Without a new version, the cached bytes are reused even though the object changed, which shows that unchanged
+  // objects are not serialized again
+  std::string before = memoized(cache, post);
+  post.comments[0].content = "changed without a new version";
+  if (memoized(cache, post) != before) {
+    fail("stale version", "object was serialized again");
+  }
+  post.comments[0].version = next_version();
+  check("stale version", cache, post);
+
+  // Erased entries are serialized again
+  size_t entries = cache.size();
+  cache.erase(post.comments[1]);
+  if (cache.size() != entries - 1) {
+    fail("erase", "entry was not dropped");
+  }
+  check("erase", cache, post);
+
+  if (failures == 0) {
+    std::cout << "All memoization tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+// Parses large arrays with parallel_json and with json<T> and checks that results and error offsets agree. Built with a
+// small PARALLEL_PARSING_MIN_SIZE, so that most inputs take the parallel path.
+#define PARALLEL_PARSING_MIN_SIZE 64
+
+#include "json-parallel.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Point {
+  int x;
+  int y;
+};
+
+struct Record {
+  std::string name;
+  std::vector<int> values;
+  Point position;
+  double weight;
+};
+
+JSON(Point, FIELDS(x, y))
+JSON(Record, FIELDS(name, values, position, weight))
+
+static int failures = 0;
+
+static std::string describe(ParseResult const &result) {
+  if (result) {
+    return "success";
+  }
+  return parse_error_code_to_string(result.error().code) + " at offset " + std::to_string(result.error().offset);
+}
+
+// Elements already in the output are kept by both parsers, which append behind them
+template <typename T> static void check_input(std::string const &test, std::string const &input, T const &prefix = {}) {
+  T serial = prefix;
+  auto serialResult = json<T>::try_deserialize(input, serial);
+  for (unsigned threads : {2, 4, 7}) {
+    T parallel = prefix;
+    auto parallelResult = parallel_json<T>::try_deserialize(input, parallel, threads);
+    // The contents of the output after an error are unspecified
+    if (describe(parallelResult) != describe(serialResult)) {
+      if (failures++ < 20) {
+        std::cerr << test << " (" << threads << " threads): expected " << describe(serialResult) << ", got "
+                  << describe(parallelResult) << std::endl;
+      }
+    } else if (serialResult && !json_equal(parallel, serial)) {
+      if (failures++ < 20) {
+        std::cerr << test << " (" << threads << " threads): parsed values differ" << std::endl;
+      }
+    }
+  }
+}
+
+// Well-formed input must actually take the parallel path, which needs the pre-scan to find every element. The serial
+// parser also accepts some malformed arrays (such as missing commas), which the pre-scan leaves to it.
+template <typename T> static void check_valid_input(std::string const &test, std::string const &input) {
+  check_input<T>(test, input);
+  T serial;
+  std::vector<ElementSlice> slices;
+  if (!json<T>::try_deserialize(input, serial)) {
+    failures++;
+    std::cerr << test << ": expected valid input" << std::endl;
+  } else if (!split_top_level_array(input.data(), input.data() + input.size(), slices) ||
+             slices.size() != serial.size()) {
+    failures++;
+    std::cerr << test << ": pre-scan found " << slices.size() << " elements instead of " << serial.size() << std::endl;
+  }
+}
+
+// Strings full of the characters that structure JSON, which the pre-scan must skip. The tokenizer ends a string at any
+// quote, so an escaped quote ends the string with a backslash. The last entry is therefore two strings, which only
+// appears in arrays of strings.
+static const char *const STRINGS[] = {"\"plain\"", "\"a,b\"", "\"]\"",   "\"],[\"", "\"[[[\"",
+                                      "\"}}}\"",   "\"{\"",   "\"\"",    "\"a\\\"", "\"x\\\", \"y\""};
+
+static std::string random_string(std::mt19937 &random, bool single = true) {
+  std::uniform_int_distribution<size_t> string(0, std::size(STRINGS) - (single ? 2 : 1));
+  return STRINGS[string(random)];
+}
+
+static std::string random_records(std::mt19937 &random, size_t count) {
+  std::uniform_int_distribution<int> number(-1000, 1000);
+  std::uniform_int_distribution<int> length(0, 5);
+  std::string input = "[";
+  for (size_t i = 0; i < count; i++) {
+    input += i > 0 ? ",\n " : "";
+    input += "{\"name\": " + random_string(random) + ", \"values\": [";
+    for (int n = length(random); n > 0; n--) {
+      input += std::to_string(number(random)) + (n > 1 ? ", " : "");
+    }
+    input += "], \"position\": {\"x\": " + std::to_string(number(random)) +
+             ", \"y\": " + std::to_string(number(random)) + "}, \"weight\": " + std::to_string(number(random)) + ".25}";
+  }
+  return input + "]";
+}
+
+static std::string random_strings(std::mt19937 &random, size_t count) {
+  std::string input = "[";
+  for (size_t i = 0; i < count; i++) {
+    input += (i > 0 ? ", " : "") + random_string(random, false);
+  }
+  return input + "]";
+}
+
+static std::string random_numbers(std::mt19937 &random, size_t count) {
+  std::uniform_int_distribution<int> number(-100000, 100000);
+  std::string input = "[";
+  for (size_t i = 0; i < count; i++) {
+    input += (i > 0 ? "," : "") + std::to_string(number(random));
+  }
+  return input + "]";
+}
+
+// Deletes, inserts or replaces a character at a random position, or cuts the input off
+static std::string mutate(std::mt19937 &random, std::string input) {
+  static const char CHARACTERS[] = {',', ']', '[', '{', '}', '"', '\\', ':', ' ', 'x', '1', '-', '.'};
+  std::uniform_int_distribution<size_t> position(0, input.size() - 1);
+  std::uniform_int_distribution<size_t> character(0, std::size(CHARACTERS) - 1);
+  size_t at = position(random);
+  switch (random() % 4) {
+  case 0:
+    return input.erase(at, 1);
+  case 1:
+    return input.insert(at, 1, CHARACTERS[character(random)]);
+  case 2:
+    input[at] = CHARACTERS[character(random)];
+    return input;
+  default:
+    return input.substr(0, at);
+  }
+}
+
+int main() {
+  std::mt19937 random(1);
+
+  for (size_t count : {0, 1, 2, 5, 100, 3000}) {
+    check_valid_input<std::vector<Record>>("records", random_records(random, count));
+    check_valid_input<std::vector<std::string>>("strings", random_strings(random, count));
+    check_valid_input<std::vector<int>>("numbers", random_numbers(random, count));
+    check_valid_input<std::vector<std::vector<int>>>("nested arrays", "[" + random_numbers(random, count) + ", [], " +
+                                                                           random_numbers(random, count) + "]");
+  }
+  check_valid_input<std::vector<int>>("whitespace", "  \n[ 1 ,2,\t3 , 4 ] \n" + std::string(100, ' '));
+  check_input<std::vector<std::string>>("appending", random_strings(random, 200), {"kept", "elements"});
+
+  for (int i = 0; i < 2000; i++) {
+    std::string records = random_records(random, 20);
+    check_input<std::vector<Record>>("malformed records " + records, mutate(random, records));
+    std::string strings = random_strings(random, 40);
+    check_input<std::vector<std::string>>("malformed strings " + strings, mutate(random, strings));
+    std::string numbers = random_numbers(random, 40);
+    check_input<std::vector<int>>("malformed numbers " + numbers, mutate(random, numbers));
+  }
+  check_input<std::vector<int>>("not an array", "{\"x\": 1}" + std::string(100, ' '));
+  std::string numbers = random_numbers(random, 50);
+  check_input<std::vector<int>>("trailing comma", numbers.substr(0, numbers.size() - 1) + ",]");
+  check_input<std::vector<int>>("unterminated", numbers.substr(0, numbers.size() - 1));
+  check_input<std::vector<int>>("trailing characters", numbers + "]");
+  check_input<std::vector<int>>("empty element", "[1, , 2]" + std::string(100, ' '));
+  check_valid_input<std::vector<std::string>>("escaped quotes", "[\"x\\\", \"y\\\", \"\\\"]" + std::string(100, ' '));
+  check_input<std::vector<std::string>>("escaped quote in a string", "[\"a\\\"b\", \"c\"]" + std::string(100, ' '));
+  check_input<std::vector<std::string>>("unbalanced quote", "[\"a\\\"\", \"" + std::string(100, 'x') + "\"]");
+
+  if (failures == 0) {
+    std::cout << "All parallel parsing tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
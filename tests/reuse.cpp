@@ -0,0 +1,165 @@
+// Parses a sequence of messages into the same object with deserialize_reusing and checks that the result equals a
+// fresh parse, and that vectors and strings keep their buffers while they shrink and grow within their capacity
+#include "json-parsing.h"
+
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct Payload {
+  virtual ~Payload() = default;
+};
+
+struct Text : Payload {
+  std::string body;
+};
+
+struct Blob : Payload {
+  std::vector<int> bytes;
+};
+
+struct Reading {
+  std::string sensor;
+  std::vector<double> samples;
+};
+
+struct Message {
+  std::string topic;
+  std::vector<int> values;
+  std::vector<std::string> tags;
+  std::vector<Reading> readings;
+  Payload *payload = nullptr;
+};
+
+JSON(Text, FIELDS(body))
+JSON(Blob, FIELDS(bytes))
+JSON(Payload *, SUBTYPES(Text, Blob))
+JSON(Reading, FIELDS(sensor, samples))
+JSON(Message, FIELDS(topic, values, tags, readings, payload))
+
+static int failures = 0;
+
+static void fail(std::string const &test, std::string const &message) {
+  std::cerr << test << ": " << message << std::endl;
+  failures++;
+}
+
+template <typename T> static std::string serialize(T const &object) {
+  std::string output;
+  auto it = std::back_inserter(output);
+  json<T>::serialize(object, it);
+  return output;
+}
+
+// Strings longer than the small string buffer, so that they live on the heap
+static std::string long_string(char c, size_t length) { return std::string(length, c); }
+
+static std::string message(size_t values, size_t tags, size_t readings, size_t samples, size_t length,
+                           std::string const &payload) {
+  std::string json = R"({"topic": ")" + long_string('t', length) + R"(", "values": [)";
+  for (size_t i = 0; i < values; i++) {
+    json += (i > 0 ? ", " : "") + std::to_string(i * 7);
+  }
+  json += R"(], "tags": [)";
+  for (size_t i = 0; i < tags; i++) {
+    json += (i > 0 ? ", \"" : "\"") + long_string('a' + i % 26, length) + "\"";
+  }
+  json += R"(], "readings": [)";
+  for (size_t i = 0; i < readings; i++) {
+    json += (i > 0 ? ", " : "") + (R"({"sensor": ")" + long_string('s', length) + R"(", "samples": [)");
+    for (size_t j = 0; j < samples; j++) {
+      json += (j > 0 ? ", " : "") + std::to_string(j) + ".5";
+    }
+    json += "]}";
+  }
+  return json + R"(], "payload": )" + payload + "}";
+}
+
+// Buffers of the members of a message that reuse must keep, as long as the new contents fit
+struct Buffers {
+  const char *topic;
+  const int *values;
+  size_t valuesCapacity;
+  const std::string *tags;
+  const char *firstTag;
+  const Reading *readings;
+  const char *firstSensor;
+  const double *firstSamples;
+
+  explicit Buffers(Message const &message)
+      : topic(message.topic.data()), values(message.values.data()), valuesCapacity(message.values.capacity()),
+        tags(message.tags.data()), firstTag(message.tags.empty() ? nullptr : message.tags[0].data()),
+        readings(message.readings.data()),
+        firstSensor(message.readings.empty() ? nullptr : message.readings[0].sensor.data()),
+        firstSamples(message.readings.empty() ? nullptr : message.readings[0].samples.data()) {}
+};
+
+static void check_buffers(std::string const &test, Buffers const &before, Message const &message) {
+  Buffers after(message);
+  if (after.topic != before.topic) {
+    fail(test, "topic was reallocated");
+  }
+  if (after.values != before.values || after.valuesCapacity != before.valuesCapacity) {
+    fail(test, "values were reallocated");
+  }
+  if (after.tags != before.tags) {
+    fail(test, "tags were reallocated");
+  }
+  // Elements that were dropped are constructed anew, so only those that were kept have to keep their buffers
+  if (before.firstTag && after.firstTag && after.firstTag != before.firstTag) {
+    fail(test, "first tag was reallocated");
+  }
+  if (after.readings != before.readings) {
+    fail(test, "readings were reallocated");
+  }
+  if (before.firstSensor && after.firstSensor &&
+      (after.firstSensor != before.firstSensor || after.firstSamples != before.firstSamples)) {
+    fail(test, "first reading was reallocated");
+  }
+}
+
+// Parses the input into the reused message and compares it with a fresh parse
+static void check_reuse(std::string const &test, std::string const &input, Message &reused, bool keepsBuffers) {
+  Buffers before(reused);
+  if (auto result = json<Message>::try_deserialize_reusing(input, reused); !result) {
+    fail(test, "parsing failed with " + parse_error_code_to_string(result.error().code));
+    return;
+  }
+  Message fresh;
+  json<Message>::deserialize(input, fresh);
+  if (serialize(reused) != serialize(fresh)) {
+    fail(test, "expected " + serialize(fresh) + ", got " + serialize(reused));
+  }
+  if (keepsBuffers) {
+    check_buffers(test, before, reused);
+  }
+}
+
+int main() {
+  Message reused;
+  check_reuse("first message", message(64, 16, 16, 64, 100, R"({"Text": {"body": "x"}})"), reused, false);
+  Payload *text = reused.payload;
+
+  check_reuse("shrinking", message(3, 2, 2, 5, 20, R"({"Text": {"body": "y"}})"), reused, true);
+  if (reused.payload != text) {
+    fail("shrinking", "payload of the same type was replaced");
+  }
+  check_reuse("growing within capacity", message(60, 15, 14, 60, 90, "null"), reused, true);
+  check_reuse("emptied", message(0, 0, 0, 0, 0, R"({"Blob": {"bytes": [1, 2]}})"), reused, true);
+  check_reuse("growing again", message(64, 16, 16, 64, 100, R"({"Text": {"body": "z"}})"), reused, true);
+  check_reuse("growing beyond capacity", message(500, 40, 40, 100, 300, "null"), reused, false);
+  check_reuse("shrinking after growing", message(1, 1, 1, 1, 16, "null"), reused, true);
+
+  // An error leaves the object in a usable state that the next message overwrites
+  json<Message>::deserialize_reusing(message(10, 3, 3, 10, 50, "null"), reused);
+  if (json<Message>::try_deserialize_reusing(message(5, 2, 2, 5, 50, "null").substr(0, 200), reused)) {
+    fail("truncated message", "expected an error");
+  }
+  check_reuse("after an error", message(4, 2, 2, 4, 50, "null"), reused, true);
+
+  if (failures == 0) {
+    std::cout << "All reuse tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// Interns overlapping sets of strings from several threads at once, directly and by parsing InternedString members,
+// and checks that equal strings share their storage and different strings do not
+#include "json-interning.h"
+
+#include <algorithm>
+#include <iostream>
+#include <latch>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define THREADS 8
+
+struct Tagged {
+  InternedString kind;
+  std::vector<InternedString> tags;
+};
+
+JSON(Tagged, FIELDS(kind, tags))
+
+static int failures = 0;
+
+static void fail(std::string const &test, std::string const &message) {
+  if (failures++ < 20) {
+    std::cerr << test << ": " << message << std::endl;
+  }
+}
+
+// Short strings that share blocks, strings that are prefixes of each other and strings long enough for a block of
+// their own
+static std::vector<std::string> vocabulary() {
+  std::vector<std::string> words;
+  for (int i = 0; i < 2000; i++) {
+    words.push_back("word" + std::to_string(i));
+  }
+  for (size_t length = 1; length <= 64; length++) {
+    words.push_back(std::string(length, 'p'));
+  }
+  for (int i = 0; i < 20; i++) {
+    words.push_back(std::string(STRING_POOL_BLOCK_SIZE / 4 + 1 + i * 100, static_cast<char>('A' + i)));
+  }
+  return words;
+}
+
+int main() {
+  std::vector<std::string> words = vocabulary();
+  // Every thread interns every word in its own order, half of them through the parser
+  std::vector<std::vector<const char *>> storage(THREADS, std::vector<const char *>(words.size()));
+  std::latch start(THREADS);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 random(t);
+      std::vector<size_t> order(words.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::shuffle(order.begin(), order.end(), random);
+      start.arrive_and_wait();
+      for (size_t i : order) {
+        // Copies, so that the pool cannot hand out the storage it was given
+        std::string word = words[i];
+        if (random() % 2 == 0) {
+          storage[t][i] = StringPool::global().intern(word).data();
+        } else {
+          Tagged tagged = json<Tagged>::deserialize(R"({"kind": ")" + word + R"(", "tags": [")" + word + R"("]})");
+          storage[t][i] = tagged.kind.data();
+          if (tagged.tags[0].data() != tagged.kind.data()) {
+            fail(word.substr(0, 20), "parsed twice in one document, interned to different storage");
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<const char *> distinct;
+  for (size_t i = 0; i < words.size(); i++) {
+    std::string test = words[i].substr(0, 20);
+    for (int t = 1; t < THREADS; t++) {
+      if (storage[t][i] != storage[0][i]) {
+        fail(test, "interned to different storage by different threads");
+      }
+    }
+    if (std::string_view(storage[0][i], words[i].size()) != words[i]) {
+      fail(test, "interned storage holds a different value");
+    }
+    distinct.insert(storage[0][i]);
+  }
+  if (distinct.size() != words.size()) {
+    fail("distinct words", "share storage");
+  }
+  if (StringPool::global().size() != words.size()) {
+    fail("pool size", "expected " + std::to_string(words.size()) + ", got " +
+                          std::to_string(StringPool::global().size()));
+  }
+  if (!StringPool::global().intern("").empty()) {
+    fail("empty string", "expected an empty view");
+  }
+
+  if (failures == 0) {
+    std::cout << "All string pool tests passed" << std::endl;
+  }
+  return failures == 0 ? 0 : 1;
+}